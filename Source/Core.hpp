@@ -14,4 +14,5 @@
 #include "Core/Shared.hpp"
 #include "Core/Processor.hpp"
 #include "Core/Audio.hpp"
+#include "Core/Debugger.hpp"
 #include "Core/Emulator.hpp"
@@ -13,19 +13,23 @@ namespace NES
 ///////////////////////////////////////////////////////////////////////////////
 APU::APU(
     Audio::Player& player,
-    IRQHandler& irq,
+    IRQHandler& frameIrq,
+    IRQHandler& dmcIrq,
     std::function<Byte(Address)> callback
 )
     : m_pulse1(1)
     , m_pulse2(2)
-    , m_dmc(irq, callback)
-    , m_counter(SetupFrameCounter(irq))
+    , m_dmc(dmcIrq, callback)
+    , m_counter(SetupFrameCounter(frameIrq))
     , m_dividedByTwo(false)
+    , m_cycles(0)
     , m_queue(player.queue)
     , m_timer(std::chrono::nanoseconds(
         int64_t(1e9) / int64_t(player.outputSampleRate)
     ))
-{}
+{
+    ScheduleFrameIRQ();
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 float APU::Mix(Byte pulse1, Byte pulse2, Byte triangle, Byte noise, Byte dmc)
@@ -59,6 +63,8 @@ float APU::Mix(Byte pulse1, Byte pulse2, Byte triangle, Byte noise, Byte dmc)
 ///////////////////////////////////////////////////////////////////////////////
 void APU::Step(void)
 {
+    bool frameIRQ = false;
+
     m_noise.Clock();
     m_dmc.Clock();
     m_triangle.Clock();
@@ -66,6 +72,7 @@ void APU::Step(void)
     if (m_dividedByTwo)
     {
         m_counter.Clock();
+        frameIRQ = m_counter.counter == Audio::FrameCounter::Q4;
         m_pulse1.Clock();
         m_pulse2.Clock();
         m_queue.Push(Mix(
@@ -77,6 +84,12 @@ void APU::Step(void)
         ));
     }
     m_dividedByTwo = !m_dividedByTwo;
+    m_cycles++;
+
+    if (frameIRQ)
+    {
+        ScheduleFrameIRQ();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -263,11 +276,18 @@ void APU::WriteRegister(Address address, Byte value)
             static_cast<Audio::FrameCounter::Mode>(value >> 7),
             value >> 6
         );
+        ScheduleFrameIRQ();
         break;
     }
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+bool APU::IsDMCFetching(void) const
+{
+    return (m_dmc.IsFetching());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 Audio::FrameCounter APU::SetupFrameCounter(IRQHandler& irq)
 {
@@ -291,4 +311,21 @@ Audio::FrameCounter APU::SetupFrameCounter(IRQHandler& irq)
     ));
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void APU::ScheduleFrameIRQ(void)
+{
+    int clocks = m_counter.GetClocksUntilIRQ();
+
+    if (clocks < 0)
+    {
+        m_counter.irq.Schedule(IRQHandler::NEVER);
+        return;
+    }
+
+    // The frame counter is clocked on every other step, and the instruction
+    // after the step that raises the interrupt is the first to see it
+    Uint64 step = m_cycles + !m_dividedByTwo + 2 * (clocks - 1);
+    m_counter.irq.Schedule(step + 1);
+}
+
 } // !namespace NES
@@ -77,6 +77,7 @@ private:
     Audio::DMC m_dmc;                   //<! Delta Modulation Channel
     Audio::FrameCounter m_counter;      //<! Frame counter for APU timing
     bool m_dividedByTwo;                //<! Indicate if it is divided by two
+    Uint64 m_cycles;                    //<! Steps since construction
     Audio::RingBuffer<float>& m_queue;  //<! Audio queue for the player
     Audio::Timer m_timer;               //<! Timer for APU operations
 
@@ -85,13 +86,15 @@ public:
     /// \brief
     ///
     /// \param player
-    /// \param irq
+    /// \param frameIrq IRQ line of the frame counter
+    /// \param dmcIrq IRQ line of the DMC
     /// \param callback
     ///
     ///////////////////////////////////////////////////////////////////////////
     APU(
         Audio::Player& player,
-        IRQHandler& irq,
+        IRQHandler& frameIrq,
+        IRQHandler& dmcIrq,
         std::function<Byte(Address)> callback
     );
 
@@ -119,6 +122,14 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     void WriteRegister(Address address, Byte value);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if the DMC may stall the CPU with a DMA fetch
+    ///
+    /// \return True if the DMC is fetching sample bytes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool IsDMCFetching(void) const;
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
@@ -130,6 +141,12 @@ private:
     ///////////////////////////////////////////////////////////////////////////
     Audio::FrameCounter SetupFrameCounter(IRQHandler& irq);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Tell the CPU when the frame counter raises its next interrupt
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void ScheduleFrameIRQ(void);
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
@@ -112,6 +112,12 @@ bool DMC::HasMoreSamples(void) const
     return (remainingBytes > 0);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+bool DMC::IsFetching(void) const
+{
+    return (changeEnabled && (remainingBytes > 0 || loop));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 bool DMC::LoadSample(void)
 {
@@ -113,6 +113,14 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     bool HasMoreSamples(void) const;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if the channel may still fetch sample bytes
+    ///
+    /// \return True if a DMA fetch, and its CPU stall, can still happen
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool IsFetching(void) const;
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
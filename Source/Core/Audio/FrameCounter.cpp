@@ -85,6 +85,23 @@ void FrameCounter::Clock(void)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+int FrameCounter::GetClocksUntilIRQ(void) const
+{
+    if (mode != Mode::Seq4Step || interruptInhibit)
+    {
+        return (-1);
+    }
+    if (counter < Q4)
+    {
+        return (Q4 - counter);
+    }
+
+    // A counter left past the 4-step wrap by the 5-step mode runs to its end
+    int wrap = counter < seq4step ? seq4step : seq5step;
+    return (wrap - counter + Q4);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void FrameCounter::Reset(Mode mode, bool irqInhibit)
 {
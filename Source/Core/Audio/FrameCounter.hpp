@@ -90,6 +90,14 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     void Clock(void);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Count the clocks left until the frame interrupt is raised
+    ///
+    /// \return The number of clocks, or -1 if no interrupt is coming
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    int GetClocksUntilIRQ(void) const;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Reset the frame counter
     ///
@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Debugger.hpp"
+#include <stdexcept>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+Debugger::Debugger(std::function<CPU::Registers(void)> registers)
+    : m_nextId(1)
+    , m_registers(registers)
+    , m_resuming(false)
+    , m_resumeAddress(0)
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+int Debugger::AddBreakpoint(Breakpoint breakpoint)
+{
+    if (breakpoint.first > breakpoint.last ||
+        (breakpoint.access & (EXECUTE | READ | WRITE)) == 0)
+    {
+        throw std::runtime_error("Breakpoint watches nothing!");
+    }
+    if (breakpoint.space == Space::PPU && (breakpoint.access & EXECUTE))
+    {
+        throw std::runtime_error("PPU addresses cannot be executed!");
+    }
+    if (breakpoint.space == Space::PPU && breakpoint.last > 0x3FFF)
+    {
+        throw std::runtime_error("PPU addresses end at $3FFF!");
+    }
+
+    breakpoint.hits = 0;
+    m_breakpoints[m_nextId] = breakpoint;
+
+    if (m_changeCallback)
+    {
+        m_changeCallback();
+    }
+    return (m_nextId++);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Debugger::RemoveBreakpoint(int id)
+{
+    m_breakpoints.erase(id);
+
+    if (m_changeCallback)
+    {
+        m_changeCallback();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Debugger::ClearBreakpoints(void)
+{
+    m_breakpoints.clear();
+    m_resuming = false;
+
+    if (m_changeCallback)
+    {
+        m_changeCallback();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Debugger::Breakpoint* Debugger::GetBreakpoint(int id) const
+{
+    auto breakpoint = m_breakpoints.find(id);
+
+    if (breakpoint == m_breakpoints.end())
+    {
+        return (nullptr);
+    }
+    return (&breakpoint->second);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 Debugger::GetWatchedPages(Space space, Access access) const
+{
+    Uint64 pages = 0;
+
+    for (const auto& [id, breakpoint] : m_breakpoints)
+    {
+        if (breakpoint.space != space || !(breakpoint.access & access))
+        {
+            continue;
+        }
+        for (int page = breakpoint.first >> 10;
+            page <= breakpoint.last >> 10; page++)
+        {
+            pages |= Uint64(1) << page;
+        }
+    }
+    return (pages);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool Debugger::Check(Space space, Access access, Address address, Byte value)
+{
+    if (access == EXECUTE)
+    {
+        // The instruction broken on is the next one run once resumed
+        bool resumed = m_resuming && address == m_resumeAddress;
+
+        m_resuming = false;
+        if (resumed)
+        {
+            return (false);
+        }
+    }
+
+    CPU::Registers registers = m_registers();
+    bool stop = false;
+    int id = 0;
+
+    for (auto& [key, breakpoint] : m_breakpoints)
+    {
+        if (breakpoint.space != space || !(breakpoint.access & access) ||
+            address < breakpoint.first || address > breakpoint.last ||
+            (breakpoint.condition && !breakpoint.condition(registers, value)))
+        {
+            continue;
+        }
+        if (++breakpoint.hits > breakpoint.skip && !stop)
+        {
+            stop = true;
+            id = key;
+        }
+    }
+
+    if (!stop)
+    {
+        return (false);
+    }
+
+    if (access == EXECUTE)
+    {
+        m_resuming = true;
+        m_resumeAddress = address;
+    }
+    if (m_breakCallback)
+    {
+        m_breakCallback({id, space, access, address, value, registers});
+    }
+    return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Debugger::SetBreakCallback(std::function<void(const Hit&)> callback)
+{
+    m_breakCallback = std::move(callback);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Debugger::SetChangeCallback(std::function<void(void)> callback)
+{
+    m_changeCallback = std::move(callback);
+}
+
+} // !namespace NES
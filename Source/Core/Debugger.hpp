@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include "Core/Processor/CPU.hpp"
+#include <functional>
+#include <map>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Breakpoints and watchpoints on the CPU and PPU address spaces
+///
+/// The debugger only decides whether an access breaks. The buses and the
+/// CPU ask it about the 1 KB pages it reports as watched, and only those:
+/// every other page keeps its direct path, so unwatched code and memory
+/// run at full speed.
+///
+///////////////////////////////////////////////////////////////////////////////
+class Debugger
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Address space a breakpoint applies to
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum class Space
+    {
+        CPU,    //<! Main bus, mapper registers included
+        PPU     //<! Picture bus
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Kind of access a breakpoint applies to, as flags
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum Access : Byte
+    {
+        EXECUTE = 0x1,  //<! Instruction about to run, CPU space only
+        READ = 0x2,     //<! Read through the bus
+        WRITE = 0x4     //<! Write through the bus
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Extra test an access must pass to count as a hit
+    ///
+    /// Receives the CPU registers at the time of the access and the byte
+    /// read or written (the opcode for EXECUTE).
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using Condition = std::function<bool(const CPU::Registers&, Byte)>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Breakpoint on a range of addresses
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Breakpoint
+    {
+        Space space;            //<! Address space watched
+        Address first;          //<! First address watched
+        Address last;           //<! Last address watched, included
+        Byte access;            //<! Access flags watched
+        Condition condition;    //<! Test of the hit, or empty for none
+        Uint64 skip;            //<! Hits to let through before breaking
+        Uint64 hits;            //<! Hits counted so far
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Access that broke
+    ///
+    /// For reads and writes, the PC is already past the instruction making
+    /// the access.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Hit
+    {
+        int id;                     //<! Breakpoint hit
+        Space space;                //<! Address space of the access
+        Access access;              //<! Kind of access
+        Address address;            //<! Address accessed
+        Byte value;                 //<! Byte read or written, or opcode
+        CPU::Registers registers;   //<! CPU state at the access
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    std::map<int, Breakpoint> m_breakpoints;        //<! Breakpoints by id
+    int m_nextId;                                   //<! Id of the next one
+    std::function<CPU::Registers(void)> m_registers;//<! CPU state source
+    std::function<void(void)> m_changeCallback;     //<! Watched pages moved
+    std::function<void(const Hit&)> m_breakCallback;//<! Told of each break
+    bool m_resuming;                                //<! Resuming past a break
+    Address m_resumeAddress;                        //<! Instruction broken on
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create a debugger without breakpoints
+    ///
+    /// \param registers Function returning the current CPU registers
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Debugger(std::function<CPU::Registers(void)> registers);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Arm a breakpoint
+    ///
+    /// \param breakpoint Breakpoint to arm, its hit count is reset
+    ///
+    /// \return Id of the breakpoint
+    ///
+    /// \throw std::runtime_error if the range is empty, no access is given
+    /// or the PPU space is executed or watched past $3FFF
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    int AddBreakpoint(Breakpoint breakpoint);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Disarm a breakpoint
+    ///
+    /// \param id Id returned by AddBreakpoint
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void RemoveBreakpoint(int id);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Disarm every breakpoint
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void ClearBreakpoints(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get an armed breakpoint, to read its hit count
+    ///
+    /// \param id Id returned by AddBreakpoint
+    ///
+    /// \return The breakpoint, or nullptr if there is none with this id
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Breakpoint* GetBreakpoint(int id) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the 1 KB pages some breakpoint watches for an access
+    ///
+    /// \param space Address space
+    /// \param access Single access flag
+    ///
+    /// \return One bit per page, bit n covering addresses n * 1 KB onwards
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 GetWatchedPages(Space space, Access access) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check an access against the breakpoints
+    ///
+    /// Every matching breakpoint counts a hit; the access breaks if one of
+    /// them has let enough hits through. An instruction broken on does not
+    /// break again when execution resumes on it.
+    ///
+    /// \param space Address space of the access
+    /// \param access Kind of access
+    /// \param address Address accessed
+    /// \param value Byte read or written, or opcode
+    ///
+    /// \return True if emulation should stop
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool Check(Space space, Access access, Address address, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Set the function told about every break
+    ///
+    /// \param callback Function receiving the access that broke
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetBreakCallback(std::function<void(const Hit&)> callback);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Set the function called when the watched pages may change
+    ///
+    /// \param callback Function updating the buses and the CPU
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetChangeCallback(std::function<void(void)> callback);
+};
+
+} // !namespace NES
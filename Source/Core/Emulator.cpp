@@ -5,6 +5,8 @@
 #include <functional>
 #include <algorithm>
 #include <iostream>
+#include <array>
+#include <thread>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -25,15 +27,22 @@ Emulator::Emulator(const Path& romPath)
     , m_apu(
         m_player,
         m_cpu.CreateIRQHandler(),
+        m_cpu.CreateIRQHandler(),
         std::bind(&Emulator::DMCDMACallback, this, std::placeholders::_1)
     )
     , m_mbus(
         m_ppu, m_apu, m_ctrl1, m_ctrl2,
         std::bind(&Emulator::OAMDMACallback, this, std::placeholders::_1)
     )
+    , m_cycles(0)
+    , m_ppuDots(0)
+    , m_apuCycles(0)
+    , m_nmiDeadline(0)
+    , m_nmiPending(false)
     , m_lastWakeUp(std::chrono::high_resolution_clock::now())
     , m_elapsedTime(m_lastWakeUp - m_lastWakeUp)
     , m_paused(false)
+    , m_break(false)
 {
     m_mapper = NES::Mapper::CreateMapper(
         m_cartridge.GetMapper(), m_cartridge, m_cpu.CreateIRQHandler(),
@@ -58,9 +67,15 @@ Emulator::Emulator(const Path& romPath)
         m_cpu.NMIInterrupt();
     });
 
+    m_mbus.SetSyncCallback(
+        std::bind(&Emulator::BusSyncCallback, this, std::placeholders::_1)
+    );
+
     m_cpu.Reset();
     m_ppu.Reset();
 
+    m_nmiDeadline = m_ppu.GetDotsUntilVBlank() / 3;
+
     m_player.Start();
 }
 
@@ -83,16 +98,7 @@ bool Emulator::IsPaused(void) const
 ///////////////////////////////////////////////////////////////////////////////
 void Emulator::SkipOneCycle(void)
 {
-    for (int i = 0; i < 29781; i++)
-    {
-        m_ppu.Step();
-        m_ppu.Step();
-        m_ppu.Step();
-
-        m_cpu.Step();
-
-        m_apu.Step();
-    }
+    RunCycles(29781);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -107,39 +113,459 @@ void Emulator::Update(void)
     m_elapsedTime += now - m_lastWakeUp;
     m_lastWakeUp = now;
 
+    Uint64 cycles = 0;
+
     while (m_elapsedTime > std::chrono::nanoseconds(559))
     {
-        m_ppu.Step();
-        m_ppu.Step();
-        m_ppu.Step();
+        m_elapsedTime -= std::chrono::nanoseconds(559);
+        cycles++;
+    }
+
+    RunCycles(cycles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const NES::Byte* Emulator::GetScreenData(void) const
+{
+    return (m_ppu.GetScreen().data());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const FrameBuffer::Frame& Emulator::GetFrame(void) const
+{
+    return (m_ppu.GetFrame());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const CPU& Emulator::GetCPU(void) const
+{
+    return (m_cpu);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::SetCPUBackend(CPUBackend backend)
+{
+    m_cpu.SetBackend(backend);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::EnableTrace(std::size_t entries)
+{
+    m_trace = std::make_unique<Trace>(entries, [&](Trace::Entry& entry)
+    {
+        int scanline, dot;
+
+        // Earlier accesses may have run the PPU up to a few dots ahead
+        SyncPPU(3 * entry.cycle);
+        m_ppu.GetPosition(
+            static_cast<int>(m_ppuDots - 3 * entry.cycle), scanline, dot
+        );
+        entry.scanline = static_cast<Uint16>(scanline);
+        entry.dot = static_cast<Uint16>(dot);
+    });
+    m_cpu.SetTrace(m_trace.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::DisableTrace(void)
+{
+    m_cpu.SetTrace(nullptr);
+    m_trace.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::DumpTrace(std::ostream& out) const
+{
+    if (m_trace)
+    {
+        m_trace->Dump(out);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::EnableCodeDataLogger(void)
+{
+    if (m_cdl)
+    {
+        return;
+    }
+
+    // CHR ROM is marked as the PPU reads it, so pixels left for later are
+    // drawn before
+    DisablePPUThread();
+    m_ppu.Flush();
+    m_cdl = std::make_unique<CodeDataLogger>(
+        m_cartridge.GetPGR().size(), m_cartridge.GetCHR().size()
+    );
+    m_cpu.SetCodeDataLogger(m_cdl.get());
+    m_mbus.SetCodeDataLogger(m_cdl.get());
+    m_pbus.SetCodeDataLogger(m_cdl.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::DisableCodeDataLogger(void)
+{
+    m_cpu.SetCodeDataLogger(nullptr);
+    m_mbus.SetCodeDataLogger(nullptr);
+    m_pbus.SetCodeDataLogger(nullptr);
+    m_cdl.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+CodeDataLogger* Emulator::GetCodeDataLogger(void)
+{
+    return (m_cdl.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::EnableProfiler(Uint64 interval)
+{
+    m_profiler = std::make_unique<Profiler>(interval, m_cpu.GetCycles());
+    m_cpu.SetProfiler(m_profiler.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::DisableProfiler(void)
+{
+    m_cpu.SetProfiler(nullptr);
+    m_profiler.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Profiler* Emulator::GetProfiler(void)
+{
+    return (m_profiler.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::EnableDebugger(void)
+{
+    if (m_debugger)
+    {
+        return;
+    }
+
+    // PPU watches stop the CPU from where the PPU runs
+    DisablePPUThread();
+    m_debugger = std::make_unique<Debugger>([&](void)
+    {
+        return (m_cpu.GetRegisters());
+    });
+    m_debugger->SetChangeCallback(
+        std::bind(&Emulator::UpdateWatches, this)
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::DisableDebugger(void)
+{
+    m_cpu.SetExecuteWatch(0, nullptr);
+    m_mbus.SetWatch(0, 0, nullptr);
+    m_pbus.SetWatch(0, 0, nullptr);
+    m_debugger.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Debugger* Emulator::GetDebugger(void)
+{
+    return (m_debugger.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::EnablePPUThread(void)
+{
+    if (m_ppuThread || m_cdl || m_debugger ||
+        std::thread::hardware_concurrency() < 2)
+    {
+        return;
+    }
 
-        m_cpu.Step();
+    // The CPU takes the NMI the next time it waits for the PPU
+    m_ppu.SetVBlankCallback([&]()
+    {
+        m_nmiPending = true;
+    });
+    m_mbus.SetPPUWriteCallback(std::bind(
+        &Emulator::PPUWriteCallback, this,
+        std::placeholders::_1, std::placeholders::_2
+    ));
+    m_ppuThread = std::make_unique<PPUThread>(m_ppu);
+}
 
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::DisablePPUThread(void)
+{
+    if (!m_ppuThread)
+    {
+        return;
+    }
+
+    m_ppuThread.reset();
+    m_mbus.SetPPUWriteCallback(nullptr);
+    m_ppu.SetVBlankCallback([&]()
+    {
+        m_cpu.NMIInterrupt();
+    });
+    if (m_nmiPending.exchange(false))
+    {
+        m_cpu.NMIInterrupt();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::UpdateWatches(void)
+{
+    using Space = Debugger::Space;
+
+    // Pixels left for later must not hit the new PPU watches
+    m_ppu.Flush();
+
+    auto stop = [&](void)
+    {
+        m_break = true;
+        m_paused = true;
+        m_cpu.EndRun();
+    };
+
+    m_cpu.SetExecuteWatch(
+        m_debugger->GetWatchedPages(Space::CPU, Debugger::EXECUTE),
+        [&, stop](Address address)
+        {
+            bool hit = m_debugger->Check(
+                Space::CPU, Debugger::EXECUTE, address, m_mbus.Peek(address)
+            );
+
+            if (hit)
+            {
+                stop();
+            }
+            return (hit);
+        }
+    );
+    m_mbus.SetWatch(
+        m_debugger->GetWatchedPages(Space::CPU, Debugger::READ),
+        m_debugger->GetWatchedPages(Space::CPU, Debugger::WRITE),
+        [&, stop](Address address, Byte value, bool write)
+        {
+            if (m_debugger->Check(Space::CPU,
+                write ? Debugger::WRITE : Debugger::READ, address, value))
+            {
+                stop();
+            }
+        }
+    );
+    m_pbus.SetWatch(
+        static_cast<Uint16>(
+            m_debugger->GetWatchedPages(Space::PPU, Debugger::READ)),
+        static_cast<Uint16>(
+            m_debugger->GetWatchedPages(Space::PPU, Debugger::WRITE)),
+        [&, stop](Address address, Byte value, bool write)
+        {
+            if (m_debugger->Check(Space::PPU,
+                write ? Debugger::WRITE : Debugger::READ, address, value))
+            {
+                stop();
+            }
+        }
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::RunCycles(Uint64 cycles)
+{
+    m_cycles += cycles;
+
+    while (m_cpu.GetCycles() < m_cycles)
+    {
+        // While the DMC can steal cycles every instruction boundary needs the
+        // APU to be up to date, otherwise only the next scheduled IRQ does
+        bool dmcFetching = m_apu.IsDMCFetching();
+
+        if (dmcFetching || m_cpu.GetCycles() >= m_cpu.GetNextIRQ())
+        {
+            // DMC stalls push the CPU clock while the APU catches up
+            while (m_apuCycles < m_cpu.GetCycles())
+            {
+                SyncAPU(m_cpu.GetCycles());
+            }
+
+            if (m_cpu.GetCycles() >= m_cycles)
+            {
+                break;
+            }
+        }
+
+        // A vblank raised during dot 3t+2 or earlier is seen by the
+        // instruction boundary at cycle t
+        if (m_cpu.GetCycles() >= m_nmiDeadline)
+        {
+            SyncPPU(3 * (m_cpu.GetCycles() + 1));
+            m_nmiDeadline = (m_ppuDots + m_ppu.GetDotsUntilVBlank()) / 3;
+        }
+
+        Uint64 deadline = m_cpu.GetCycles() + 1;
+
+        if (!dmcFetching)
+        {
+            // A source may schedule its line at the cycle it was synced to
+            deadline = std::max(deadline, std::min({
+                m_cycles, m_nmiDeadline, m_cpu.GetNextIRQ()
+            }));
+        }
+        // PPU watches can also be hit while catching the PPU up
+        if (m_break)
+        {
+            break;
+        }
+        m_cpu.Run(deadline);
+    }
+
+    if (m_break)
+    {
+        // The machine stops where the breakpoint left it
+        m_break = false;
+        m_cycles = m_cpu.GetCycles();
+    }
+
+    // The PPU thread may draw the rest of the frame while the caller goes on
+    RunPPU(3 * m_cycles);
+    SyncAPU(m_cycles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::SyncPPU(Uint64 dots)
+{
+    RunPPU(dots);
+
+    if (m_ppuThread)
+    {
+        m_ppuThread->Wait();
+        if (m_nmiPending.exchange(false))
+        {
+            m_cpu.NMIInterrupt();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::RunPPU(Uint64 dots)
+{
+    Uint64 run = TakePPUDots(dots);
+
+    if (run == 0)
+    {
+        return;
+    }
+    if (m_ppuThread)
+    {
+        m_ppuThread->Run(run);
+    }
+    else
+    {
+        m_ppu.Run(run);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 Emulator::TakePPUDots(Uint64 dots)
+{
+    Uint64 run = m_ppuDots < dots ? dots - m_ppuDots : 0;
+
+    m_ppuDots += run;
+    return (run);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::SyncAPU(Uint64 cycles)
+{
+    while (m_apuCycles < cycles)
+    {
         m_apu.Step();
+        m_apuCycles++;
+    }
+}
 
-        m_elapsedTime -= std::chrono::nanoseconds(559);
+///////////////////////////////////////////////////////////////////////////////
+void Emulator::BusSyncCallback(Address address)
+{
+    Uint64 cycle = m_cpu.GetCycles();
+
+    if (address < MainBus::APU_REGISTER_START ||
+        address == MainBus::OAM_DMA || address >= 0x8000)
+    {
+        // Mapper writes switch CHR banks and mirroring under the PPU. On
+        // its thread, the DMA is queued like the register writes are, which
+        // leaves the register reads and the mapper writes here
+        if (address != MainBus::OAM_DMA || !m_ppuThread)
+        {
+            SyncPPU(3 * (cycle + 1));
+        }
+
+        if (address >= 0x8000)
+        {
+            // Lines left for later are drawn with the banks they were run with
+            m_ppu.Flush();
+
+            // They may also bank out the rest of the block being run
+            m_cpu.EndRun();
+        }
+    }
+    else if (
+        address <= MainBus::JOY2_AND_FRAME_CONTROL &&
+        address != MainBus::JOY1
+    )
+    {
+        // The access may start the DMC, so the run must be rescheduled
+        SyncAPU(cycle);
+        m_cpu.EndRun();
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-const NES::Byte* Emulator::GetScreenData(void) const
+void Emulator::PPUWriteCallback(Address address, Byte value)
 {
-    return (m_ppu.GetScreen().data());
+    m_ppuThread->Write(
+        TakePPUDots(3 * (m_cpu.GetCycles() + 1)), address, value
+    );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 Byte Emulator::DMCDMACallback(Address address)
 {
     m_cpu.SkipDMCDMACycles();
-    return (m_pbus.Read(address));
+    if (m_cdl)
+    {
+        m_cdl->LogPGR(
+            m_mbus.GetPGROffset(address), address, CodeDataLogger::PCM_DATA
+        );
+    }
+    return (m_mbus.Read(address));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void Emulator::OAMDMACallback(Byte page)
 {
+    Uint64 dots = 3 * (m_cpu.GetCycles() + 1);
+
     m_cpu.SkipOAMDMACycles();
     auto pagePtr = m_mbus.GetPagePtr(page);
-    if (pagePtr != nullptr)
+    std::array<Byte, 0x100> buffer;
+
+    if (pagePtr == nullptr)
+    {
+        // Register pages have no memory behind them, read them one by one
+        for (int i = 0; i < 0x100; i++)
+        {
+            buffer[i] = m_mbus.Read(static_cast<Address>(page << 8 | i));
+        }
+        pagePtr = buffer.data();
+    }
+
+    if (m_ppuThread)
+    {
+        m_ppuThread->DMA(TakePPUDots(dots), pagePtr);
+    }
+    else
     {
         m_ppu.DoDMA(pagePtr);
     }
@@ -15,6 +15,8 @@
 #include "Core/Picture.hpp"
 #include "Core/Processor.hpp"
 #include "Core/Shared.hpp"
+#include "Core/Debugger.hpp"
+#include <atomic>
 #include <memory>
 #include <chrono>
 
@@ -51,9 +53,20 @@ private:
     Controller m_ctrl1;                 //<!
     Controller m_ctrl2;                 //<!
     MainBus m_mbus;                     //<!
+    Uint64 m_cycles;                    //<! CPU cycles emulated so far
+    Uint64 m_ppuDots;                   //<! Dots the PPU has run
+    Uint64 m_apuCycles;                 //<! Cycles the APU has run
+    Uint64 m_nmiDeadline;               //<! First cycle an NMI can be seen
+    std::atomic<bool> m_nmiPending;     //<! NMI raised on the PPU thread
     TimePoint m_lastWakeUp;             //<!
     Duration m_elapsedTime;             //<!
     bool m_paused;                      //<!
+    std::unique_ptr<Trace> m_trace;     //<! CPU trace, when enabled
+    std::unique_ptr<CodeDataLogger> m_cdl; //<! ROM use log, when enabled
+    std::unique_ptr<Profiler> m_profiler; //<! Guest profiler, when enabled
+    std::unique_ptr<Debugger> m_debugger; //<! Breakpoints, when enabled
+    bool m_break;                       //<! A breakpoint stopped the run
+    std::unique_ptr<PPUThread> m_ppuThread; //<! PPU thread, when enabled
 
 public:
     ///////////////////////////////////////////////////////////////////////////
@@ -99,7 +112,224 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     const NES::Byte* GetScreenData(void) const;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the current screen as palette indices
+    ///
+    /// A quarter of the size of GetScreenData, and never converted to RGBA;
+    /// Palette::Expand does that where and when needed. Safe to call from
+    /// another thread than the one running the emulator, as long as it is
+    /// the only one calling this and GetScreenData.
+    ///
+    /// \return The frame, with its number, left untouched until the next
+    /// call to either function
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const FrameBuffer::Frame& GetFrame(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the emulated CPU, for statistics and debugging
+    ///
+    /// \return A constant reference to the CPU
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const CPU& GetCPU(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Select how the CPU executes code
+    ///
+    /// \param backend Interpreter or dynarec
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetCPUBackend(CPUBackend backend);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start recording the last instructions the CPU executes
+    ///
+    /// Recording makes the CPU interpret every instruction one at a time,
+    /// so it is much slower than a normal run.
+    ///
+    /// \param entries Number of instructions kept, a power of two
+    ///
+    /// \throw std::runtime_error if entries is not a power of two
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EnableTrace(std::size_t entries);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Stop recording instructions and drop the trace
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DisableTrace(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write the recorded instructions in the nestest log format
+    ///
+    /// Does nothing if the trace is not enabled.
+    ///
+    /// \param out Stream to write to
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DumpTrace(std::ostream& out) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start marking how PGR and CHR ROM bytes are used
+    ///
+    /// Does nothing if the logger is already enabled.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EnableCodeDataLogger(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Stop marking ROM use and drop the log
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DisableCodeDataLogger(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the Code/Data Logger, to save or inspect it
+    ///
+    /// \return The logger, or nullptr if it is not enabled
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    CodeDataLogger* GetCodeDataLogger(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start sampling where the guest program spends its cycles
+    ///
+    /// Replaces any profiler already enabled, dropping its samples.
+    ///
+    /// \param interval Number of CPU cycles between two samples
+    ///
+    /// \throw std::runtime_error if the interval is zero
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EnableProfiler(Uint64 interval);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Stop sampling and drop the profile
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DisableProfiler(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the profiler, to load symbols or write the profile
+    ///
+    /// \return The profiler, or nullptr if it is not enabled
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Profiler* GetProfiler(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start checking breakpoints
+    ///
+    /// A breakpoint hit pauses the emulator once the current instruction
+    /// completes, or before the instruction for execute breakpoints;
+    /// TogglePause resumes. Only the pages some breakpoint watches leave
+    /// the fast paths of the CPU and the buses.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EnableDebugger(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Stop checking breakpoints and drop them
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DisableDebugger(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the debugger, to set breakpoints
+    ///
+    /// \return The debugger, or nullptr if it is not enabled
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Debugger* GetDebugger(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start running the PPU on a thread of its own
+    ///
+    /// The CPU then only queues the PPU register writes and OAM DMAs, and
+    /// waits for the PPU to catch up when reading its registers, writing to
+    /// the mapper or when an NMI may be due. Frames are drawn while the CPU
+    /// runs on, so the one GetFrame returns may be one behind. Does nothing
+    /// on a single core host, or while the Code/Data Logger or the debugger
+    /// is enabled; enabling either stops the thread.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EnablePPUThread(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Catch the PPU up and run it on the emulator thread again
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DisablePPUThread(void);
+
 private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Advance the machine by a number of CPU cycles
+    ///
+    /// The CPU runs whole instructions; the PPU and APU are caught up to it
+    /// only when the bus touches them, when an NMI can become visible, when
+    /// an IRQ source has scheduled its line, and while the DMC may steal
+    /// cycles.
+    ///
+    /// \param cycles Number of CPU cycles to emulate
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void RunCycles(Uint64 cycles);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Run the PPU up to a dot count
+    ///
+    /// On the PPU thread, waits for it to get there.
+    ///
+    /// \param dots Number of dots the PPU should have run
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SyncPPU(Uint64 dots);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Run the PPU up to a dot count, without waiting for its thread
+    ///
+    /// \param dots Number of dots the PPU should have run
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void RunPPU(Uint64 dots);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Count the dots the PPU has left to run to reach a dot count
+    ///
+    /// \param dots Number of dots the PPU should have run
+    ///
+    /// \return The dots to run, now counted in m_ppuDots
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 TakePPUDots(Uint64 dots);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Run the APU up to a cycle count
+    ///
+    /// \param cycles Number of cycles the APU should have run
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SyncAPU(Uint64 cycles);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Callback for main bus accesses to the devices
+    ///
+    /// \param address Address being accessed
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void BusSyncCallback(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Callback for PPU register writes, while on the PPU thread
+    ///
+    /// \param address Register written, $2000-$2007
+    /// \param value Value written
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void PPUWriteCallback(Address address, Byte value);
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Callback for DMC DMA operations
     ///
@@ -117,6 +347,12 @@ private:
     ///
     ///////////////////////////////////////////////////////////////////////////
     void OAMDMACallback(Byte page);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Divert the pages the breakpoints watch from the fast paths
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void UpdateWatches(void);
 };
 
 } // !namespace NES
@@ -35,4 +35,19 @@ enum class MirroringType
     UPPER_SINGLE_SCREEN     //<! Upper Single-screen mirroring
 };
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Enumeration of the ways the CPU can execute code
+///
+/// - INTERPRETER: Every instruction runs through its handler. This is the
+///                reference the other backends are checked against.
+/// - DYNAREC: Hot blocks of PGR ROM code are translated to x86-64 and run
+///            natively, everything else is interpreted.
+///
+///////////////////////////////////////////////////////////////////////////////
+enum class CPUBackend
+{
+    INTERPRETER,            //<! Interpret every instruction
+    DYNAREC                 //<! Run hot ROM blocks as translated code
+};
+
 } // !namespace NES
@@ -21,6 +21,8 @@ namespace NES
 Mapper::Mapper(Cartridge& cartridge, Uint8 id)
     : id(id)
     , m_cartridge(cartridge)
+    , m_pagesPGR{}
+    , m_pagesCHR{}
 {}
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -39,6 +41,82 @@ MirroringType Mapper::GetMirroringType(void) const
 void Mapper::ScanlineIRQ(void)
 {}
 
+///////////////////////////////////////////////////////////////////////////////
+const Byte* Mapper::GetPGRPointer(Address address) const
+{
+    const Byte* page = m_pagesPGR[(address >> 10) & 0x1F];
+
+    if (!page)
+    {
+        return (nullptr);
+    }
+    return (page + (address & 0x3FF));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Int32 Mapper::GetPGROffset(Address address) const
+{
+    const Byte* pointer = GetPGRPointer(address);
+
+    if (!pointer)
+    {
+        return (-1);
+    }
+    return (static_cast<Int32>(pointer - m_cartridge.GetPGR().data()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Byte* Mapper::GetCHRPointer(Address address) const
+{
+    const Byte* page = m_pagesCHR[(address >> 10) & 0x7];
+
+    if (!page)
+    {
+        return (nullptr);
+    }
+    return (page + (address & 0x3FF));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Int32 Mapper::GetCHROffset(Address address) const
+{
+    NES_UNUSED(address);
+    return (-1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Mapper::MapPGR(Address address, Uint32 size, Uint32 offset)
+{
+    const Rom<Byte>& pgr = m_cartridge.GetPGR();
+
+    if (pgr.empty())
+    {
+        return;
+    }
+
+    for (Uint32 page = 0; page < size; page += 0x400)
+    {
+        m_pagesPGR[((address + page) >> 10) & 0x1F] =
+            &pgr[(offset + page) % pgr.size()];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Mapper::MapCHR(
+    Address address,
+    Uint32 size,
+    const std::vector<Byte>& memory,
+    Uint32 offset
+)
+{
+    for (Uint32 page = 0; page < size; page += 0x400)
+    {
+        m_pagesCHR[((address + page) >> 10) & 0x7] =
+            offset + page + 0x400 <= memory.size()
+            ? &memory[offset + page] : nullptr;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 std::unique_ptr<Mapper> Mapper::CreateMapper(
     Uint8 type,
@@ -11,6 +11,7 @@
 #include "Core/Enums.hpp"
 #include <memory>
 #include <functional>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -45,6 +46,8 @@ protected:
     // Protected members
     ///////////////////////////////////////////////////////////////////////////
     Cartridge& m_cartridge;         //<! Reference to the cartridge
+    const Byte* m_pagesPGR[32];     //<! PGR ROM behind each 1 KB page
+    const Byte* m_pagesCHR[8];      //<! CHR memory behind each 1 KB page
 
 public:
     ///////////////////////////////////////////////////////////////////////////
@@ -117,6 +120,88 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     virtual MirroringType GetMirroringType(void) const;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the PGR ROM byte mapped at an address
+    ///
+    /// \param address Address in $8000-$FFFF
+    ///
+    /// \return Pointer to the mapped byte, or nullptr if the mapper does not
+    /// publish its PGR banks
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Byte* GetPGRPointer(Address address) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the PGR ROM offset mapped at an address
+    ///
+    /// The offset names the byte independently of the current banking, so
+    /// it stays valid across bank switches.
+    ///
+    /// \param address Address in $8000-$FFFF
+    ///
+    /// \return Offset into PGR ROM, or -1 if the address is not published
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Int32 GetPGROffset(Address address) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the CHR ROM offset mapped at a pattern table address
+    ///
+    /// \param address Address in $0000-$1FFF
+    ///
+    /// \return Offset into CHR ROM, or -1 if the mapper does not report it
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    virtual Int32 GetCHROffset(Address address) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the CHR memory mapped at a pattern table address
+    ///
+    /// The pointer is into CHR ROM or into the mapper's CHR RAM, whose
+    /// contents may change through WriteCHR.
+    ///
+    /// \param address Address in $0000-$1FFF
+    ///
+    /// \return Pointer to the mapped byte, or nullptr if the mapper does not
+    /// publish its CHR banks
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Byte* GetCHRPointer(Address address) const;
+
+protected:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Publish a window of PGR ROM at a CPU address
+    ///
+    /// Mappers call it whenever they switch PGR banks, so that the published
+    /// pages always match what ReadPGR returns.
+    ///
+    /// \param address First CPU address of the window, 1 KB aligned
+    /// \param size Size of the window, multiple of 1 KB
+    /// \param offset Offset of the window in PGR ROM, wrapped to its size
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void MapPGR(Address address, Uint32 size, Uint32 offset);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Publish a window of CHR ROM or RAM at a PPU address
+    ///
+    /// Mappers call it whenever they switch CHR banks, so that the published
+    /// pages always match what ReadCHR returns. Pages past the end of the
+    /// memory are left unpublished.
+    ///
+    /// \param address First PPU address of the window, 1 KB aligned
+    /// \param size Size of the window, multiple of 1 KB
+    /// \param memory CHR ROM or RAM the window is into
+    /// \param offset Offset of the window in the memory
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void MapCHR(
+        Address address,
+        Uint32 size,
+        const std::vector<Byte>& memory,
+        Uint32 offset
+    );
+
 public:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
@@ -21,6 +21,8 @@ AxROM::AxROM(Cartridge& cartridge, std::function<void(void)> callback)
     {
         m_ram.resize(0x2000, 0x00);
     }
+    MapPGR(0x8000, 0x8000, 0);
+    MapCHR(0x0000, 0x2000, m_ram, 0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -39,6 +41,7 @@ void AxROM::WritePGR(Address address, Byte value)
     if (address >= 0x8000)
     {
         m_pgrBank = value & 0x07;
+        MapPGR(0x8000, 0x8000, m_pgrBank * 0x8000);
         m_mirroring = (value & 0x10) ?
             MirroringType::UPPER_SINGLE_SCREEN :
             MirroringType::LOWER_SINGLE_SCREEN;
@@ -20,6 +20,8 @@ CNROM::CNROM(Cartridge& cartridge)
     {
         m_oneBank = true;
     }
+    MapPGR(0x8000, 0x8000, 0);
+    MapCHR(0x0000, 0x2000, m_cartridge.GetCHR(), 0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,6 +38,7 @@ Byte CNROM::ReadPGR(Address address)
 void CNROM::WritePGR(Address address, Byte value)
 {
     m_selectCHR = value & 0x3;
+    MapCHR(0x0000, 0x2000, m_cartridge.GetCHR(), m_selectCHR << 13);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -51,4 +54,10 @@ void CNROM::WriteCHR(Address address, Byte value)
     NES_UNUSED(value);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+Int32 CNROM::GetCHROffset(Address address) const
+{
+    return (address | (m_selectCHR << 13));
+}
+
 } // !namespace NES::Mappers
@@ -15,7 +15,12 @@ GxROM::GxROM(Cartridge& cartridge, std::function<void(void)> callback)
     : Mapper(cartridge, 66)
     , m_mirroring(MirroringType::VERTICAL)
     , m_callback(callback)
-{}
+    , m_pgrBank(0)
+    , m_chrBank(0)
+{
+    MapPGR(0x8000, 0x8000, 0);
+    MapCHR(0x0000, 0x2000, m_cartridge.GetCHR(), 0);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 Byte GxROM::ReadPGR(Address address)
@@ -36,6 +41,8 @@ void GxROM::WritePGR(Address address, Byte value)
     {
         m_pgrBank = ((value & 0x30) >> 4);
         m_chrBank = (value & 0x3);
+        MapPGR(0x8000, 0x8000, m_pgrBank * 0x8000);
+        MapCHR(0x0000, 0x2000, m_cartridge.GetCHR(), m_chrBank * 0x2000);
         m_mirroring = MirroringType::VERTICAL;
     }
     m_callback();
@@ -58,6 +65,12 @@ void GxROM::WriteCHR(Address address, Byte value)
     NES_UNUSED(value);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+Int32 GxROM::GetCHROffset(Address address) const
+{
+    return (m_chrBank * 0x2000 + address);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 MirroringType GxROM::GetMirroringType(void) const
 {
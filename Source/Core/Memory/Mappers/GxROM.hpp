@@ -81,6 +81,16 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     virtual void WriteCHR(Address address, Byte value) override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief
+    ///
+    /// \param address
+    ///
+    /// \return
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    virtual Int32 GetCHROffset(Address address) const override;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
     ///
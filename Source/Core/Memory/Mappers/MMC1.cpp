@@ -35,8 +35,8 @@ MMC1::MMC1(Cartridge& cartridge, std::function<void(void)> callback)
         m_bankCHRIndex[0] = 0;
         m_bankCHRIndex[1] = 0x1000 * m_regCHR[1];
     }
-    m_bankPGR[0] = &m_cartridge.GetPGR()[0];
-    m_bankPGR[1] = &m_cartridge.GetPGR()[m_cartridge.GetPGR().size() - 0x4000];
+    CalculatePGRPointers();
+    MapCHRBanks();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -120,6 +120,7 @@ void MMC1::WritePGR(Address address, Byte value)
                 CalculatePGRPointers();
             }
 
+            MapCHRBanks();
             m_register = 0;
             m_writeCount = 0;
         }
@@ -151,6 +152,19 @@ void MMC1::CalculatePGRPointers(void)
         m_bankPGR[0] = &m_cartridge.GetPGR()[0x4000 * m_regPGR];
         m_bankPGR[1] = &m_cartridge.GetPGR()[m_cartridge.GetPGR().size() - 0x4000];
     }
+
+    MapPGR(0x8000, 0x4000, m_bankPGR[0] - m_cartridge.GetPGR().data());
+    MapPGR(0xC000, 0x4000, m_bankPGR[1] - m_cartridge.GetPGR().data());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MMC1::MapCHRBanks(void)
+{
+    const std::vector<Byte>& memory =
+        m_usesCHRRAM ? m_ram : m_cartridge.GetCHR();
+
+    MapCHR(0x0000, 0x1000, memory, m_bankCHRIndex[0]);
+    MapCHR(0x1000, 0x1000, memory, m_bankCHRIndex[1]);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -188,6 +202,20 @@ void MMC1::WriteCHR(Address address, Byte value)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+Int32 MMC1::GetCHROffset(Address address) const
+{
+    if (m_usesCHRRAM)
+    {
+        return (-1);
+    }
+    if (address < 0x1000)
+    {
+        return (m_bankCHRIndex[0] + address);
+    }
+    return (m_bankCHRIndex[1] + (address & 0xFFF));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 MirroringType MMC1::GetMirroringType(void) const
 {
@@ -89,6 +89,16 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     virtual void WriteCHR(Address address, Byte value) override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief
+    ///
+    /// \param address
+    ///
+    /// \return
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    virtual Int32 GetCHROffset(Address address) const override;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
     ///
@@ -103,6 +113,12 @@ private:
     ///
     ///////////////////////////////////////////////////////////////////////////
     void CalculatePGRPointers(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Publish the CHR banks selected by the CHR registers
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void MapCHRBanks(void);
 };
 
 } // !namespace NES::Mappers
@@ -21,6 +21,9 @@ NROM::NROM(Cartridge& cartridge)
     {
         m_chrRAM.resize(0x2000, 0x00);
     }
+    MapPGR(0x8000, 0x8000, 0);
+    MapCHR(0x0000, 0x2000,
+        m_usesCHRRam ? m_chrRAM : m_cartridge.GetCHR(), 0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -67,4 +70,14 @@ void NROM::WriteCHR(Address address, Byte value)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+Int32 NROM::GetCHROffset(Address address) const
+{
+    if (m_usesCHRRam)
+    {
+        return (-1);
+    }
+    return (address);
+}
+
 } // !namespace NES::Mappers
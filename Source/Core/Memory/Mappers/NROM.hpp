@@ -75,6 +75,16 @@ public:
     ///
     ///////////////////////////////////////////////////////////////////////////
     virtual void WriteCHR(Address address, Byte value) override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief
+    ///
+    /// \param address
+    ///
+    /// \return
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    virtual Int32 GetCHROffset(Address address) const override;
 };
 
 } // !namespace NES::Mappers
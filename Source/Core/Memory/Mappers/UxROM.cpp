@@ -22,6 +22,9 @@ UxROM::UxROM(Cartridge& cartridge)
         m_ram.resize(0x2000, 0x00);
     }
     m_bankPtr = &m_cartridge.GetPGR()[m_cartridge.GetPGR().size() - 0x4000];
+    MapPGR(0x8000, 0x4000, 0);
+    MapPGR(0xC000, 0x4000, m_cartridge.GetPGR().size() - 0x4000);
+    MapCHR(0x0000, 0x2000, m_usesCHRRAM ? m_ram : m_cartridge.GetCHR(), 0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -41,6 +44,7 @@ void UxROM::WritePGR(Address address, Byte value)
 {
     NES_UNUSED(address);
     m_selectPGR = value;
+    MapPGR(0x8000, 0x4000, m_selectPGR << 14);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -62,4 +66,14 @@ void UxROM::WriteCHR(Address address, Byte value)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+Int32 UxROM::GetCHROffset(Address address) const
+{
+    if (m_usesCHRRAM)
+    {
+        return (-1);
+    }
+    return (address);
+}
+
 } // !namespace NES::Mappers
@@ -6,5 +6,11 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/Compositor.hpp"
+#include "Core/Picture/FrameBuffer.hpp"
+#include "Core/Picture/Palette.hpp"
+#include "Core/Picture/TileCache.hpp"
 #include "Core/Picture/PictureBus.hpp"
 #include "Core/Picture/PPU.hpp"
+#include "Core/Picture/PPUThread.hpp"
+#include "Core/Picture/WorkerPool.hpp"
@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/Compositor.hpp"
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+    #define NES_COMPOSITOR_X86
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+static bool ComposeScalar(
+    const Compositor::Line& line,
+    int first,
+    int count,
+    Uint16* output
+)
+{
+    bool hit = false;
+
+    for (int x = first; x < first + count; x++)
+    {
+        Byte bg = line.background[x];
+        Byte spr = line.sprites[x];
+        bool bgOpaque = (bg & 0x3) && !(line.clipBackground && x < 8);
+        bool sprOpaque = (spr & 0x3) && !(line.clipSprites && x < 8);
+        Byte address = bgOpaque ? bg : 0;
+
+        if (sprOpaque && (!bgOpaque || !(spr & Compositor::BEHIND)))
+        {
+            address = spr & 0x1F;
+        }
+        if (sprOpaque && bgOpaque && (spr & Compositor::SPRITE_ZERO))
+        {
+            hit = true;
+        }
+
+        output[x] = line.palette[address] | line.emphasis;
+    }
+    return (hit);
+}
+
+#ifdef NES_COMPOSITOR_X86
+
+///////////////////////////////////////////////////////////////////////////////
+static bool ComposeSSE2(
+    const Compositor::Line& line,
+    int first,
+    int count,
+    Uint16* output
+)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi8(0x03);
+    const __m128i behind = _mm_set1_epi8(Compositor::BEHIND);
+    const __m128i spriteZero = _mm_set1_epi8(Compositor::SPRITE_ZERO);
+    const __m128i address = _mm_set1_epi8(0x1F);
+    const __m128i lanes = _mm_setr_epi8(
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+    );
+    const __m128i clipBackground = _mm_set1_epi8(line.clipBackground ? -1 : 0);
+    const __m128i clipSprites = _mm_set1_epi8(line.clipSprites ? -1 : 0);
+    int end = first + count;
+    int hits = 0;
+    int x = first;
+
+    for (; x + 16 <= end; x += 16)
+    {
+        __m128i bg = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(line.background + x)
+        );
+        __m128i spr = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(line.sprites + x)
+        );
+        __m128i bgClear = _mm_cmpeq_epi8(_mm_and_si128(bg, opaque), zero);
+        __m128i sprClear = _mm_cmpeq_epi8(_mm_and_si128(spr, opaque), zero);
+
+        if (x < 8)
+        {
+            // Dots 0-7 are the ones for which x - 7 saturates to 0
+            __m128i dots = _mm_add_epi8(_mm_set1_epi8(x), lanes);
+            __m128i edge = _mm_cmpeq_epi8(
+                _mm_subs_epu8(dots, _mm_set1_epi8(7)), zero
+            );
+
+            bgClear = _mm_or_si128(bgClear, _mm_and_si128(edge,
+                clipBackground));
+            sprClear = _mm_or_si128(sprClear, _mm_and_si128(edge,
+                clipSprites));
+        }
+
+        __m128i front = _mm_cmpeq_epi8(_mm_and_si128(spr, behind), zero);
+        __m128i useSprite = _mm_andnot_si128(
+            sprClear, _mm_or_si128(bgClear, front)
+        );
+        __m128i hit = _mm_andnot_si128(
+            _mm_or_si128(sprClear, bgClear),
+            _mm_cmpeq_epi8(_mm_and_si128(spr, spriteZero), spriteZero)
+        );
+        __m128i result = _mm_or_si128(
+            _mm_and_si128(useSprite, _mm_and_si128(spr, address)),
+            _mm_andnot_si128(useSprite, _mm_andnot_si128(bgClear, bg))
+        );
+
+        // SSE2 cannot shuffle bytes, the palette is read one dot at a time
+        alignas(16) Byte addresses[16];
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(addresses), result);
+        hits |= _mm_movemask_epi8(hit);
+
+        for (int i = 0; i < 16; i++)
+        {
+            output[x + i] = line.palette[addresses[i]] | line.emphasis;
+        }
+    }
+    bool tail = ComposeScalar(line, x, end - x, output);
+
+    return (hits != 0 || tail);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+__attribute__((target("avx2")))
+static bool ComposeAVX2(
+    const Compositor::Line& line,
+    int first,
+    int count,
+    Uint16* output
+)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi8(0x03);
+    const __m256i behind = _mm256_set1_epi8(Compositor::BEHIND);
+    const __m256i spriteZero = _mm256_set1_epi8(Compositor::SPRITE_ZERO);
+    const __m256i address = _mm256_set1_epi8(0x1F);
+    const __m256i emphasis = _mm256_set1_epi16(line.emphasis);
+    const __m256i lanes = _mm256_setr_epi8(
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+        16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+    );
+    const __m256i clipBackground =
+        _mm256_set1_epi8(line.clipBackground ? -1 : 0);
+    const __m256i clipSprites = _mm256_set1_epi8(line.clipSprites ? -1 : 0);
+
+    // Both halves of the palette in each 128-bit lane, for the shuffles
+    const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(line.palette)
+    ));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(line.palette + 16)
+    ));
+    int end = first + count;
+    int hits = 0;
+    int x = first;
+
+    for (; x + 32 <= end; x += 32)
+    {
+        __m256i bg = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(line.background + x)
+        );
+        __m256i spr = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(line.sprites + x)
+        );
+        __m256i bgClear =
+            _mm256_cmpeq_epi8(_mm256_and_si256(bg, opaque), zero);
+        __m256i sprClear =
+            _mm256_cmpeq_epi8(_mm256_and_si256(spr, opaque), zero);
+
+        if (x < 8)
+        {
+            __m256i dots = _mm256_add_epi8(_mm256_set1_epi8(x), lanes);
+            __m256i edge = _mm256_cmpeq_epi8(
+                _mm256_subs_epu8(dots, _mm256_set1_epi8(7)), zero
+            );
+
+            bgClear = _mm256_or_si256(bgClear, _mm256_and_si256(edge,
+                clipBackground));
+            sprClear = _mm256_or_si256(sprClear, _mm256_and_si256(edge,
+                clipSprites));
+        }
+
+        __m256i front =
+            _mm256_cmpeq_epi8(_mm256_and_si256(spr, behind), zero);
+        __m256i useSprite = _mm256_andnot_si256(
+            sprClear, _mm256_or_si256(bgClear, front)
+        );
+        __m256i hit = _mm256_andnot_si256(
+            _mm256_or_si256(sprClear, bgClear),
+            _mm256_cmpeq_epi8(_mm256_and_si256(spr, spriteZero), spriteZero)
+        );
+        __m256i result = _mm256_or_si256(
+            _mm256_and_si256(useSprite, _mm256_and_si256(spr, address)),
+            _mm256_andnot_si256(useSprite, _mm256_andnot_si256(bgClear, bg))
+        );
+
+        // Bit 4 of the address, moved to bit 7, picks the palette half
+        __m256i colors = _mm256_blendv_epi8(
+            _mm256_shuffle_epi8(low, result),
+            _mm256_shuffle_epi8(high, result),
+            _mm256_slli_epi16(result, 3)
+        );
+
+        hits |= _mm256_movemask_epi8(hit);
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(output + x),
+            _mm256_or_si256(emphasis, _mm256_cvtepu8_epi16(
+                _mm256_castsi256_si128(colors)
+            ))
+        );
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(output + x + 16),
+            _mm256_or_si256(emphasis, _mm256_cvtepu8_epi16(
+                _mm256_extracti128_si256(colors, 1)
+            ))
+        );
+    }
+    bool tail = ComposeScalar(line, x, end - x, output);
+
+    return (hits != 0 || tail);
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+bool Compositor::Compose(
+    const Line& line,
+    int first,
+    int count,
+    Uint16* output
+)
+{
+    using Composer = bool (*)(const Line&, int, int, Uint16*);
+
+#ifdef NES_COMPOSITOR_X86
+    static const Composer composer =
+        __builtin_cpu_supports("avx2") ? ComposeAVX2 : ComposeSSE2;
+#else
+    static const Composer composer = ComposeScalar;
+#endif
+
+    return (composer(line, first, count, output));
+}
+
+} // !namespace NES
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Mix of the background and sprite pixels of a scanline
+///
+/// Both layers are given as one byte per dot, whose low 2 bits are 0 where
+/// the layer is transparent. Picking the visible pixel, clipping the left
+/// 8 dots and spotting sprite 0 hits are done 32 dots at a time with AVX2
+/// when the host supports it, checked once, and 16 at a time with SSE2 or
+/// one at a time otherwise.
+///
+///////////////////////////////////////////////////////////////////////////////
+class Compositor
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Flags of a sprite pixel, above its palette address
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum Flags : Byte
+    {
+        BEHIND = 0x20,      //<! Drawn behind an opaque background
+        SPRITE_ZERO = 0x40  //<! Belongs to sprite 0
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Scanline to composite
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Line
+    {
+        const Byte* background; //<! Palette address per dot, $00-$0F
+        const Byte* sprites;    //<! Palette address $10-$1F and Flags
+        const Byte* palette;    //<! Color of each palette address
+        bool clipBackground;    //<! Hide the background in dots 0-7
+        bool clipSprites;       //<! Hide the sprites in dots 0-7
+        Uint16 emphasis;        //<! Emphasis bits of the Palette indices
+    };
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Composite dots of a scanline
+    ///
+    /// \param line Layers of the scanline
+    /// \param first First dot, 0 to 255
+    /// \param count Number of dots
+    /// \param output Receives the Palette index of each dot, from the one
+    /// at index first onwards
+    ///
+    /// \return True if sprite 0 hit the background on one of the dots
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static bool Compose(
+        const Line& line,
+        int first,
+        int count,
+        Uint16* output
+    );
+};
+
+} // !namespace NES
@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/FrameBuffer.hpp"
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+FrameBuffer::FrameBuffer(std::size_t size)
+    : m_ready(1)
+    , m_back(0)
+    , m_front(2)
+    , m_lastHash(0)
+{
+    for (Frame& frame : m_frames)
+    {
+        frame.pixels.assign(size, 0);
+        frame.number = 0;
+        frame.hash = 0;
+        frame.changed = false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint16* FrameBuffer::GetBack(void)
+{
+    return (m_frames[m_back].pixels.data());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameBuffer::Publish(Uint64 number, Uint64 hash)
+{
+    m_frames[m_back].number = number;
+    m_frames[m_back].hash = hash;
+    m_frames[m_back].changed = number == 1 || hash != m_lastHash;
+    m_lastHash = hash;
+
+    // Releases the pixels drawn, and acquires the frame the consumer let go
+    m_back = m_ready.exchange(m_back | FRESH, std::memory_order_acq_rel) & 3;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const FrameBuffer::Frame& FrameBuffer::Acquire(void)
+{
+    if (m_ready.load(std::memory_order_relaxed) & FRESH)
+    {
+        m_front = m_ready.exchange(m_front, std::memory_order_acq_rel) & 3;
+    }
+    return (m_frames[m_front]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 FrameBuffer::Hash(const Uint16* pixels, std::size_t count, Uint64 hash)
+{
+    for (std::size_t i = 0; i < count; i += 4)
+    {
+        Uint64 word;
+
+        std::memcpy(&word, pixels + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3;
+        hash ^= hash >> 29;
+    }
+    return (hash);
+}
+
+} // !namespace NES
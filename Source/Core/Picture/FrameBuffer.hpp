@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Triple buffer handing the frames of the PPU to a consumer
+///
+/// The PPU draws into the back frame and publishes it by swapping its index
+/// with the ready one; the consumer takes the ready frame by swapping it
+/// with the front one. Neither ever copies nor waits, and since each side
+/// owns its frame until the next swap, the consumer may read from another
+/// thread without tearing. There must be a single producer and a single
+/// consumer.
+///
+///////////////////////////////////////////////////////////////////////////////
+class FrameBuffer
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Frame completed by the PPU
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        std::vector<Uint16> pixels; //<! Palette index per pixel, row by row
+        Uint64 number;              //<! 1 for the first frame, 0 for none
+        Uint64 hash;                //<! Hash of the pixels
+        bool changed;               //<! Pixels differ from the last frame's
+    };
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    // Public constants
+    ///////////////////////////////////////////////////////////////////////////
+    constexpr static Uint64 HASH_SEED = 0xCBF29CE484222325; //<! Empty hash
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private constants
+    ///////////////////////////////////////////////////////////////////////////
+    constexpr static Byte FRESH = 0x4;  //<! Ready frame not yet acquired
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    Frame m_frames[3];          //<! Back, ready and front frames
+    std::atomic<Byte> m_ready;  //<! Index of the ready frame, and FRESH
+    Byte m_back;                //<! Index of the frame drawn, producer only
+    Byte m_front;               //<! Index of the frame read, consumer only
+    Uint64 m_lastHash;          //<! Hash of the last frame published
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create the three frames, with number 0
+    ///
+    /// \param size Number of pixels of a frame
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    FrameBuffer(std::size_t size);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the frame to draw into
+    ///
+    /// \return Pixels of the back frame, valid until Publish
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint16* GetBack(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Make the back frame the ready one, and draw into another
+    ///
+    /// \param number Number of the frame
+    /// \param hash Hash of its pixels, from Hash
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Publish(Uint64 number, Uint64 hash);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the last frame published
+    ///
+    /// \return The frame, left untouched until the next call
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Frame& Acquire(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Hash pixels, 4 at a time
+    ///
+    /// Meant to tell frames apart, not to resist collisions on purpose. A
+    /// frame hashed in pieces, each one seeding the next, gets the same
+    /// hash as in one go if the pieces are multiples of 4 pixels.
+    ///
+    /// \param pixels Pixels to hash
+    /// \param count Number of pixels, a multiple of 4
+    /// \param hash HASH_SEED, or the hash of the pixels before
+    ///
+    /// \return The hash
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static Uint64 Hash(const Uint16* pixels, std::size_t count, Uint64 hash);
+};
+
+} // !namespace NES
@@ -2,8 +2,13 @@
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
 #include "Core/Picture/PPU.hpp"
-#include "Core/Colors.hpp"
+#include "Core/Picture/Compositor.hpp"
+#include "Core/Picture/Palette.hpp"
+#include <algorithm>
+#include <bit>
 #include <cstring>
+#include <initializer_list>
+#include <thread>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -15,21 +20,27 @@ namespace NES
 PPU::PPU(PictureBus& bus)
     : m_bus(bus)
     , m_screen(SCANLINE_VISIBLE_DOTS * VISIBLE_SCANLINES * 4, 0xFF)
-    , m_buffer(SCANLINE_VISIBLE_DOTS * VISIBLE_SCANLINES * 4, 0xFF)
+    , m_screenNumber(0)
+    , m_frames(SCANLINE_VISIBLE_DOTS * VISIBLE_SCANLINES)
+    , m_buffer(m_frames.GetBack())
+    , m_frameNumber(0)
+    , m_sprLines(SCANLINE_VISIBLE_DOTS * VISIBLE_SCANLINES, 0)
+    , m_spriteZeroLine(false)
+    , m_pool(std::max(std::thread::hardware_concurrency(), 1u) - 1)
     , m_spriteMemory(256, 0x00)
 {
+    IndexSprites();
+    m_spans.reserve(VISIBLE_SCANLINES);
+
+    // Magenta until the first frame is complete
     for (int x = 0; x < SCANLINE_VISIBLE_DOTS; x++)
     {
         for (int y = 0; y < VISIBLE_SCANLINES; y++)
         {
             m_screen[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 0] = 0xFF; // R
-            m_buffer[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 0] = 0xFF; // R
             m_screen[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 1] = 0x00; // G
-            m_buffer[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 1] = 0x00; // G
             m_screen[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 2] = 0xFF; // B
-            m_buffer[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 2] = 0xFF; // B
             m_screen[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 3] = 0xFF; // A
-            m_buffer[(y * SCANLINE_VISIBLE_DOTS + x) * 4 + 3] = 0xFF; // A
         }
     }
 }
@@ -37,9 +48,24 @@ PPU::PPU(PictureBus& bus)
 ///////////////////////////////////////////////////////////////////////////////
 const std::vector<Byte>& PPU::GetScreen(void) const
 {
+    const FrameBuffer::Frame& frame = m_frames.Acquire();
+
+    if (frame.number != m_screenNumber)
+    {
+        Palette::Expand(
+            frame.pixels.data(), m_screen.data(), frame.pixels.size()
+        );
+        m_screenNumber = frame.number;
+    }
     return (m_screen);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+const FrameBuffer::Frame& PPU::GetFrame(void) const
+{
+    return (m_frames.Acquire());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PPU::Step(void)
 {
@@ -64,12 +90,49 @@ void PPU::Step(void)
     m_cycle++;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void PPU::Run(Uint64 dots)
+{
+    while (dots > 0)
+    {
+        if (
+            m_pipelineState == State::RENDER &&
+            m_cycle > 0 && m_cycle <= SCANLINE_VISIBLE_DOTS
+        )
+        {
+            // Visible dots do nothing but draw, so draw all of them at once
+            int span = static_cast<int>(std::min<Uint64>(
+                dots, SCANLINE_VISIBLE_DOTS + 1 - m_cycle
+            ));
+
+            RenderSpan(m_cycle - 1, span);
+            m_cycle += span;
+            dots -= span;
+        }
+        else if (int idle = GetDotsUntilEvent())
+        {
+            // Nothing happens before the event but counting dots
+            Uint64 skipped = std::min<Uint64>(dots, idle);
+
+            m_cycle += static_cast<int>(skipped);
+            dots -= skipped;
+        }
+        else
+        {
+            Step();
+            dots--;
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PPU::Reset(void)
 {
     m_longSprites = false;
     m_generateInterrupt = false;
     m_greyscaleMode = false;
+    m_emphasis = 0;
+    m_bus.SetGreyscale(false);
     m_vblank = false;
     m_spriteOverflow = false;
     m_showBackground = true;
@@ -86,8 +149,10 @@ void PPU::Reset(void)
     m_tempAddress = 0x00;
     m_dataAddrIncrement = 1;
     m_pipelineState = State::PRE_RENDER;
-    m_scanlineSprites.reserve(8);
-    m_scanlineSprites.resize(0);
+    m_spriteCount = 0;
+    std::fill(m_sprLines.begin(), m_sprLines.end(), 0);
+    m_spriteZeroLine = false;
+    m_spans.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -119,6 +184,9 @@ void PPU::PreRenderStep(void)
         m_pipelineState = State::RENDER;
         m_cycle = 0;
         m_scanline = 0;
+
+        // The first line draws the sprites found at the end of the last one
+        DrawSprites();
     }
 
     // Handle IRQ for MMC3 mapper
@@ -133,147 +201,7 @@ void PPU::RenderStep(void)
 {
     if (m_cycle > 0 && m_cycle <= SCANLINE_VISIBLE_DOTS)
     {
-        Byte bgColor = 0;
-        Byte sprColor = 0;
-        bool bgOpaque = false;
-        bool sprOpaque = true;
-        bool spriteForeground = false;
-
-        int x = m_cycle - 1;
-        int y = m_scanline;
-
-        if (m_showBackground)
-        {
-            int x_fine = (m_fineXScroll + x) % 8;
-
-            if (!m_hideEdgeBackground || x >= 8)
-            {
-                int addr = 0x2000 | (m_dataAddress & 0x0FFF);
-                Byte tile = m_bus.Read(addr);
-
-                addr = (tile * 16) + ((m_dataAddress >> 12) & 0x7);
-                addr |= static_cast<int>(m_bgPage) << 12;
-                bgColor = (m_bus.Read(addr) >> (7 ^ x_fine)) & 1;
-                bgColor |= ((m_bus.Read(addr + 8) >> (7 ^ x_fine)) & 1) << 1;
-
-                bgOpaque = bgColor;
-
-                addr = 0x23C0 |
-                    (m_dataAddress & 0x0C00) |
-                    ((m_dataAddress >> 4) & 0x38) |
-                    ((m_dataAddress >> 2) & 0x07);
-                Byte attribute = m_bus.Read(addr);
-                int shift = ((m_dataAddress >> 4) & 4) | (m_dataAddress & 2);
-                bgColor |= ((attribute >> shift) & 0x3) << 2;
-            }
-
-            if (x_fine == 7)
-            {
-                if ((m_dataAddress & 0x001F) == 31)
-                {
-                    m_dataAddress &= ~0x001F;
-                    m_dataAddress ^= 0x0400;
-                }
-                else
-                {
-                    m_dataAddress += 1;
-                }
-            }
-        }
-
-        if (m_showSprites && (!m_hideEdgeSprites || x >= 8))
-        {
-            for (Byte i : m_scanlineSprites)
-            {
-                Byte spr_x = m_spriteMemory[i * 4 + 3];
-
-                if (0 > x - spr_x || x - spr_x >= 8)
-                {
-                    continue;
-                }
-
-                Byte spr_y = m_spriteMemory[i * 4 + 0] + 1;
-                Byte tile = m_spriteMemory[i * 4 + 1];
-                Byte attribute = m_spriteMemory[i * 4 + 2];
-
-                int length = (m_longSprites) ? 16 : 8;
-
-                int x_shift = (x - spr_x) % 8;
-                int y_offset = (y - spr_y) % length;
-
-                if ((attribute & 0x40) == 0)
-                {
-                    x_shift ^= 7;
-                }
-                if ((attribute & 0x80) != 0)
-                {
-                    y_offset ^= (length - 1);
-                }
-
-                Address addr = 0;
-
-                if (!m_longSprites)
-                {
-                    addr = tile * 16 + y_offset;
-                    if (m_sprPage == CharacterPage::HIGH)
-                    {
-                        addr += 0x1000;
-                    }
-                }
-                else
-                {
-                    y_offset = (y_offset & 7) | ((y_offset & 8) << 1);
-                    addr = (tile >> 1) * 32 + y_offset;
-                    addr |= (tile & 1) << 12;
-                }
-
-                sprColor |= (m_bus.Read(addr) >> (x_shift)) & 1;
-                sprColor |= ((m_bus.Read(addr + 8) >> (x_shift)) & 1) << 1;
-
-                if (!(sprOpaque = sprColor))
-                {
-                    sprColor = 0;
-                    continue;
-                }
-
-                sprColor |= 0x10;
-                sprColor |= (attribute & 0x3) << 2;
-
-                spriteForeground = !(attribute & 0x20);
-
-                if (
-                    !m_sprZeroHit && m_showBackground &&
-                    i == 0 && sprOpaque && bgOpaque
-                )
-                {
-                    m_sprZeroHit = true;
-                }
-
-                break;
-            }
-        }
-
-        Byte paletteAddr = bgColor;
-
-        if (
-            (!bgOpaque && sprOpaque) ||
-            (bgOpaque && sprOpaque && spriteForeground)
-        )
-        {
-            paletteAddr = sprColor;
-        }
-        else if (!bgOpaque && !sprOpaque)
-        {
-            paletteAddr = 0;
-        }
-
-        int index = y * SCANLINE_VISIBLE_DOTS * 4 + x * 4;
-        Uint32 color = NES_COLORS[m_bus.ReadPalette(paletteAddr)];
-
-        m_buffer[index + 0] = (color >> 24) & 0xFF; // R
-        m_buffer[index + 1] = (color >> 16) & 0xFF; // G
-        m_buffer[index + 2] = (color >> 8) & 0xFF;  // B
-        m_buffer[index + 3] = 0xFF;                 // A
+        RenderSpan(m_cycle - 1, 1);
     }
     else if (m_cycle == SCANLINE_VISIBLE_DOTS + 1 && m_showBackground)
     {
@@ -319,32 +247,33 @@ void PPU::RenderStep(void)
 
     if (m_cycle >= SCANLINE_END_CYCLE)
     {
-        m_scanlineSprites.resize(0);
+        m_spriteCount = 0;
 
-        int range = 8;
+        // Sprites on the line, from the OAM address on and in OAM order
+        Uint64 sprites = m_spriteRows[0][m_scanline];
         if (m_longSprites)
         {
-            range = 16;
+            sprites |= m_spriteRows[1][m_scanline];
         }
+        sprites &= ~Uint64(0) << (m_spriteDataAddress / 4);
 
-        size_t j = 0;
-        for (size_t i = m_spriteDataAddress / 4; i < 64; i++)
+        for (; sprites; sprites &= sprites - 1)
         {
-            int diff = (m_scanline - m_spriteMemory[i * 4]);
-            if (0 <= diff && diff < range)
+            if (m_spriteCount >= 8)
             {
-                if (j >= 8)
-                {
-                    m_spriteOverflow = true;
-                    break;
-                }
-                m_scanlineSprites.push_back(i);
-                j++;
+                m_spriteOverflow = true;
+                break;
             }
+            m_scanlineSprites[m_spriteCount++] = std::countr_zero(sprites);
         }
 
         m_scanline++;
         m_cycle = 0;
+
+        if (m_scanline < VISIBLE_SCANLINES)
+        {
+            DrawSprites();
+        }
     }
 
     if (m_scanline >= VISIBLE_SCANLINES)
@@ -353,6 +282,265 @@ void PPU::RenderStep(void)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+static Address ScrollX(Address address, int fineX, int first, int count)
+{
+    // Coarse X moves on the last dot of each tile, at most 32 times a line
+    int steps = (fineX + first + count) / 8 - (fineX + first) / 8;
+    int coarse = (address & 0x001F) + steps;
+
+    if (coarse >= 32)
+    {
+        address ^= 0x0400;
+    }
+    return ((address & ~0x001F) | (coarse & 0x001F));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::RenderSpan(int first, int count)
+{
+    Span span = {
+        m_scanline, first, count, m_dataAddress, m_fineXScroll, m_bgPage,
+        m_showBackground, m_showSprites, m_hideEdgeBackground,
+        m_hideEdgeSprites, m_emphasis, {}
+    };
+
+    std::memcpy(span.colors, m_bus.GetColors(), sizeof(span.colors));
+
+    if (m_showBackground)
+    {
+        m_dataAddress = ScrollX(m_dataAddress, m_fineXScroll, first, count);
+    }
+
+    // Once sprite 0 hit, the flag stays set until the next frame
+    bool sprite0 = m_spriteZeroLine && m_showBackground && m_showSprites &&
+        !m_sprZeroHit;
+
+    // Reads that are logged or watched must happen when the PPU does them
+    if (m_pool.GetWorkers() > 0 && !sprite0 && !m_bus.IsMonitored())
+    {
+        m_spans.push_back(span);
+    }
+    else if (DrawSpan(span, false))
+    {
+        m_sprZeroHit = true;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::Flush(void)
+{
+    if (m_spans.empty())
+    {
+        return;
+    }
+
+    m_bus.PrepareTiles();
+    m_pool.Run(m_spans.size(), [&](std::size_t i)
+    {
+        DrawSpan(m_spans[i], true);
+    });
+    m_spans.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool PPU::DrawSpan(const Span& span, bool shared) const
+{
+    // Sprites hidden since their line was drawn are only left out
+    static const Byte hidden[SCANLINE_VISIBLE_DOTS] = {};
+    Byte background[SCANLINE_VISIBLE_DOTS];
+
+    if (span.showBackground)
+    {
+        DrawBackground(span, shared, background);
+    }
+    else
+    {
+        std::fill_n(background + span.first, span.count, 0);
+    }
+
+    Compositor::Line line = {
+        background,
+        span.showSprites
+            ? &m_sprLines[span.scanline * SCANLINE_VISIBLE_DOTS] : hidden,
+        span.colors, span.hideEdgeBackground, span.hideEdgeSprites,
+        span.emphasis
+    };
+
+    return (Compositor::Compose(
+        line, span.first, span.count,
+        m_buffer + span.scanline * SCANLINE_VISIBLE_DOTS
+    ));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::DrawBackground(const Span& span, bool shared, Byte* line) const
+{
+    // Background tile last fetched, refetched whenever the address moves
+    Address dataAddress = span.dataAddress;
+    int fetched = -1;
+    const Byte* bgRow = nullptr;
+    Byte bgPixels[8];
+    Byte bgPalette = 0;
+
+    for (int x = span.first; x < span.first + span.count; x++)
+    {
+        int x_fine = (span.fineXScroll + x) % 8;
+
+        if (fetched != dataAddress)
+        {
+            const PictureBus::NameTable* table =
+                m_bus.GetNameTable(dataAddress);
+            int row = (dataAddress >> 5) & 0x1F;
+            int column = dataAddress & 0x1F;
+            int addr = 0x2000 | (dataAddress & 0x0FFF);
+            Byte tile = (table)
+                ? table->tiles[row][column] : m_bus.Read(addr);
+
+            addr = (tile * 16) + ((dataAddress >> 12) & 0x7);
+            addr |= static_cast<int>(span.bgPage) << 12;
+
+            const TileCache::Tile* decoded =
+                shared ? m_bus.FindTile(addr) : m_bus.GetTile(addr);
+
+            if (decoded)
+            {
+                bgRow = decoded->pixels[addr & 7];
+            }
+            else
+            {
+                TileCache::DecodeRow(
+                    m_bus.Read(addr), m_bus.Read(addr + 8), bgPixels
+                );
+                bgRow = bgPixels;
+            }
+
+            if (table)
+            {
+                bgPalette = table->palettes[row][column];
+            }
+            else
+            {
+                addr = 0x23C0 |
+                    (dataAddress & 0x0C00) |
+                    ((dataAddress >> 4) & 0x38) |
+                    ((dataAddress >> 2) & 0x07);
+                Byte attribute = m_bus.Read(addr);
+                int shift =
+                    ((dataAddress >> 4) & 4) | (dataAddress & 2);
+                bgPalette = ((attribute >> shift) & 0x3) << 2;
+            }
+
+            fetched = dataAddress;
+        }
+
+        line[x] = bgRow[x_fine] | bgPalette;
+
+        if (x_fine == 7)
+        {
+            if ((dataAddress & 0x001F) == 31)
+            {
+                dataAddress &= ~0x001F;
+                dataAddress ^= 0x0400;
+            }
+            else
+            {
+                dataAddress += 1;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::DrawSprites(void)
+{
+    int y = m_scanline;
+    int length = (m_longSprites) ? 16 : 8;
+    // Drawn even while sprites are hidden, as they may be shown mid-line
+    int sprites = m_spriteCount;
+    const Byte* sprRows[8] = {};
+    Byte sprPixels[8][8];
+
+    for (int j = 0; j < sprites; j++)
+    {
+        Byte i = m_scanlineSprites[j];
+        Byte spr_y = m_spriteMemory[i * 4 + 0] + 1;
+        Byte tile = m_spriteMemory[i * 4 + 1];
+        Byte attribute = m_spriteMemory[i * 4 + 2];
+        int y_offset = (y - spr_y) % length;
+
+        if ((attribute & 0x80) != 0)
+        {
+            y_offset ^= (length - 1);
+        }
+
+        Address addr = 0;
+
+        if (!m_longSprites)
+        {
+            addr = tile * 16 + y_offset;
+            if (m_sprPage == CharacterPage::HIGH)
+            {
+                addr += 0x1000;
+            }
+        }
+        else
+        {
+            y_offset = (y_offset & 7) | ((y_offset & 8) << 1);
+            addr = (tile >> 1) * 32 + y_offset;
+            addr |= (tile & 1) << 12;
+        }
+
+        // Rows of a tile sit in its first 8 bytes, so a negative offset
+        // into the previous tile takes the bus like on hardware
+        const TileCache::Tile* decoded = (addr < 0x2000 && !(addr & 8))
+            ? m_bus.GetTile(addr) : nullptr;
+
+        if (decoded)
+        {
+            sprRows[j] = (attribute & 0x40)
+                ? decoded->flipped[addr & 7] : decoded->pixels[addr & 7];
+            continue;
+        }
+
+        TileCache::DecodeRow(
+            m_bus.Read(addr), m_bus.Read(addr + 8), sprPixels[j]
+        );
+        if (attribute & 0x40)
+        {
+            std::reverse(sprPixels[j], sprPixels[j] + 8);
+        }
+        sprRows[j] = sprPixels[j];
+    }
+
+    Byte* sprLine = &m_sprLines[y * SCANLINE_VISIBLE_DOTS];
+
+    std::fill_n(sprLine, SCANLINE_VISIBLE_DOTS, 0);
+    m_spriteZeroLine = false;
+
+    // Sprites first in OAM win, so they are drawn last
+    for (int j = sprites - 1; j >= 0; j--)
+    {
+        Byte i = m_scanlineSprites[j];
+        m_spriteZeroLine |= i == 0;
+        Byte attribute = m_spriteMemory[i * 4 + 2];
+        int spr_x = m_spriteMemory[i * 4 + 3];
+        const Byte* sprRow = sprRows[j];
+        Byte flags = 0x10 | (attribute & 0x3) << 2 |
+            (attribute & 0x20 ? Compositor::BEHIND : 0) |
+            (i == 0 ? Compositor::SPRITE_ZERO : 0);
+        int right = std::min(SCANLINE_VISIBLE_DOTS, spr_x + 8);
+
+        for (int x = spr_x; x < right; x++)
+        {
+            if (sprRow[x - spr_x])
+            {
+                sprLine[x] = sprRow[x - spr_x] | flags;
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PPU::PostRenderStep(void)
 {
@@ -365,11 +553,14 @@ void PPU::PostRenderStep(void)
         m_cycle = 0;
         m_pipelineState = State::VERTICAL_BLANK;
 
-        // If we are at the last scanline, copy the buffer to the screen
-        for (size_t i = 0; i < m_buffer.size(); i++)
-        {
-            m_screen[i] = m_buffer[i];
-        }
+        // Every pixel of the buffer was drawn, so it is published as is and
+        // the next frame is drawn over an older one
+        Flush();
+        m_frames.Publish(++m_frameNumber, FrameBuffer::Hash(
+            m_buffer, SCANLINE_VISIBLE_DOTS * VISIBLE_SCANLINES,
+            FrameBuffer::HASH_SEED
+        ));
+        m_buffer = m_frames.GetBack();
     }
 }
 
@@ -404,6 +595,101 @@ void PPU::VerticalBlankStep(void)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+int PPU::GetDotsUntilVBlank(void) const
+{
+    // Every line after the first one of a frame runs cycles 1 to 340
+    int dots = SCANLINE_END_CYCLE - m_cycle + 1;
+    int lines = 0;
+
+    switch (m_pipelineState)
+    {
+    case State::PRE_RENDER:
+        dots -= 1;
+        lines = VISIBLE_SCANLINES + 1;
+        break;
+    case State::RENDER:
+        lines = VISIBLE_SCANLINES - m_scanline;
+        break;
+    case State::POST_RENDER:
+        lines = 0;
+        break;
+    case State::VERTICAL_BLANK:
+        if (m_scanline == VISIBLE_SCANLINES + 1 && m_cycle <= 1)
+        {
+            return (1 - m_cycle);
+        }
+        dots -= 1;
+        lines = FRAME_END_SCANLINE - m_scanline + VISIBLE_SCANLINES + 1;
+        break;
+    }
+
+    return (dots + lines * SCANLINE_END_CYCLE);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int GetDotsUntil(int cycle, std::initializer_list<int> events)
+{
+    for (int event : events)
+    {
+        if (event >= cycle)
+        {
+            return (event - cycle);
+        }
+    }
+    return (0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int PPU::GetDotsUntilEvent(void) const
+{
+    switch (m_pipelineState)
+    {
+    case State::PRE_RENDER:
+        if (m_cycle > 280 && m_cycle <= 304)
+        {
+            return (0);
+        }
+        // The line ends a dot early on odd frames
+        return (GetDotsUntil(m_cycle, {
+            1, SCANLINE_VISIBLE_DOTS + 2, 260, 281,
+            SCANLINE_END_CYCLE - 1, SCANLINE_END_CYCLE
+        }));
+    case State::RENDER:
+        if (m_cycle > 0 && m_cycle <= SCANLINE_VISIBLE_DOTS)
+        {
+            return (0);
+        }
+        return (GetDotsUntil(m_cycle, {
+            1, SCANLINE_VISIBLE_DOTS + 1, SCANLINE_VISIBLE_DOTS + 2, 260,
+            SCANLINE_END_CYCLE
+        }));
+    case State::VERTICAL_BLANK:
+        if (m_scanline == VISIBLE_SCANLINES + 1)
+        {
+            return (GetDotsUntil(m_cycle, {1, SCANLINE_END_CYCLE}));
+        }
+        break;
+    case State::POST_RENDER:
+        break;
+    }
+    return (GetDotsUntil(m_cycle, {SCANLINE_END_CYCLE}));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::GetPosition(int dotsAgo, int& scanline, int& dot) const
+{
+    scanline = m_pipelineState == State::PRE_RENDER
+        ? FRAME_END_SCANLINE : m_scanline;
+    dot = m_cycle - dotsAgo;
+
+    while (dot < 0)
+    {
+        dot += SCANLINE_END_CYCLE;
+        scanline = scanline == 0 ? FRAME_END_SCANLINE : scanline - 1;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PPU::SetVBlankCallback(std::function<void(void)> callback)
 {
@@ -435,6 +721,8 @@ void PPU::Control(Byte control)
 void PPU::SetMask(Byte mask)
 {
     m_greyscaleMode = mask & 0x1;
+    m_emphasis = (mask & 0xE0) << 1;
+    m_bus.SetGreyscale(m_greyscaleMode);
     m_hideEdgeBackground = !(mask & 0x2);
     m_hideEdgeSprites = !(mask & 0x4);
     m_showBackground = mask & 0x8;
@@ -486,6 +774,8 @@ void PPU::SetScroll(Byte scroll)
 ///////////////////////////////////////////////////////////////////////////////
 void PPU::SetData(Byte data)
 {
+    // Pixels left for later must see the memory as it was
+    Flush();
     m_bus.Write(m_dataAddress, data);
     m_dataAddress += m_dataAddrIncrement;
 }
@@ -493,7 +783,19 @@ void PPU::SetData(Byte data)
 ///////////////////////////////////////////////////////////////////////////////
 void PPU::SetOAMData(Byte data)
 {
-    m_spriteMemory[(m_spriteDataAddress++)] = data;
+    // A new Y moves the sprite to other lines
+    bool moved = m_spriteDataAddress % 4 == 0;
+
+    if (moved)
+    {
+        IndexSprite(m_spriteDataAddress / 4, false);
+    }
+    m_spriteMemory[m_spriteDataAddress] = data;
+    if (moved)
+    {
+        IndexSprite(m_spriteDataAddress / 4, true);
+    }
+    m_spriteDataAddress++;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -510,7 +812,7 @@ Byte PPU::GetStatus(void)
 ///////////////////////////////////////////////////////////////////////////////
 Byte PPU::GetData(void)
 {
-    Byte data = m_bus.Read(m_dataAddress);
+    Byte data = m_bus.ReadData(m_dataAddress);
 
     m_dataAddress += m_dataAddrIncrement;
     if (m_dataAddress < 0x3F00)
@@ -542,6 +844,35 @@ void PPU::DoDMA(const Byte* pagePtr)
             pagePtr + (256 - m_spriteDataAddress), m_spriteDataAddress
         );
     }
+
+    IndexSprites();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::IndexSprite(int sprite, bool add)
+{
+    Uint64 bit = Uint64(1) << sprite;
+    int top = m_spriteMemory[sprite * 4];
+    int bottom = std::min(top + 16, VISIBLE_SCANLINES);
+
+    // Evaluation finds a sprite on the 8 or 16 lines from its Y on
+    for (int line = top; line < bottom; line++)
+    {
+        Uint64& sprites = m_spriteRows[(line - top) / 8][line];
+
+        sprites = (add) ? (sprites | bit) : (sprites & ~bit);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPU::IndexSprites(void)
+{
+    std::memset(m_spriteRows, 0, sizeof(m_spriteRows));
+
+    for (int sprite = 0; sprite < 64; sprite++)
+    {
+        IndexSprite(sprite, true);
+    }
 }
 
 } // !namespace NES
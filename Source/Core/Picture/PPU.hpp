@@ -6,7 +6,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/FrameBuffer.hpp"
 #include "Core/Picture/PictureBus.hpp"
+#include "Core/Picture/WorkerPool.hpp"
 #include "Utils.hpp"
 #include <functional>
 #include <vector>
@@ -49,6 +51,26 @@ private:
         HIGH        //<! High character page
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Pixels of a scanline, with the state they are drawn from
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Span
+    {
+        int scanline;               //<! Visible scanline, 0 to 239
+        int first;                  //<! Column of the first pixel
+        int count;                  //<! Number of pixels
+        Address dataAddress;        //<! VRAM address at the first pixel
+        Byte fineXScroll;           //<! Fine X scroll
+        CharacterPage bgPage;       //<! Pattern table of the background
+        bool showBackground;        //<! Background enabled
+        bool showSprites;           //<! Sprites enabled
+        bool hideEdgeBackground;    //<! Background clipped in dots 0-7
+        bool hideEdgeSprites;       //<! Sprites clipped in dots 0-7
+        Uint16 emphasis;            //<! Emphasis bits of the Palette indices
+        Byte colors[0x20];          //<! Palette as displayed
+    };
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     // Private constants
@@ -65,11 +87,20 @@ private:
     // Private members
     ///////////////////////////////////////////////////////////////////////////
     PictureBus& m_bus;
-    std::vector<Byte> m_screen;
-    std::vector<Byte> m_buffer;
+    mutable std::vector<Byte> m_screen;
+    mutable Uint64 m_screenNumber;
+    mutable FrameBuffer m_frames;
+    Uint16* m_buffer;
+    Uint64 m_frameNumber;
+    std::vector<Byte> m_sprLines;
+    bool m_spriteZeroLine;
+    std::vector<Span> m_spans;
+    WorkerPool m_pool;
     std::function<void(void)> m_vblankCallback;
     std::vector<Byte> m_spriteMemory;
-    std::vector<Byte> m_scanlineSprites;
+    Byte m_scanlineSprites[8];
+    int m_spriteCount;
+    Uint64 m_spriteRows[2][VISIBLE_SCANLINES];
     State m_pipelineState;
     int m_cycle;
     int m_scanline;
@@ -86,6 +117,7 @@ private:
     bool m_longSprites;
     bool m_generateInterrupt;
     bool m_greyscaleMode;
+    Uint16 m_emphasis;
     bool m_showSprites;
     bool m_showBackground;
     bool m_hideEdgeSprites;
@@ -107,17 +139,56 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Get the current screen buffer
     ///
+    /// The last frame is converted to RGBA on the first call after it is
+    /// complete. Takes the frame like GetFrame does.
+    ///
     /// \return A constant reference to the screen buffer vector
     ///
     ///////////////////////////////////////////////////////////////////////////
     const std::vector<Byte>& GetScreen(void) const;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the last frame as output by the PPU
+    ///
+    /// May be called from another thread than the one running the PPU, but
+    /// from a single one, which GetScreen must also be called from.
+    ///
+    /// \return The frame, left untouched until the next call
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const FrameBuffer::Frame& GetFrame(void) const;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Step through the PPU pipeline
     ///
     ///////////////////////////////////////////////////////////////////////////
     void Step(void);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Step through the PPU pipeline a number of times
+    /// Runs of visible dots are drawn in a single pass that fetches each
+    /// tile once rather than once per pixel. Since the PPU is only run up to
+    /// the CPU accesses that could change its output, a register written in
+    /// the middle of a scanline simply ends the pass at that dot. Dots up to
+    /// the next event are skipped in one go.
+    /// \param dots Number of dots to step through
+    ///////////////////////////////////////////////////////////////////////////
+    void Run(Uint64 dots);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the pixels left for later
+    ///
+    /// On hosts with several cores, pixels that cannot hit sprite 0, and
+    /// whose reads are not logged or watched, are only recorded with the
+    /// registers and palette they depend on, then drawn by a pool of
+    /// threads at the end of the frame, or before whatever else they depend
+    /// on changes. The PPU flushes before writing its
+    /// memory itself; the mapper must be flushed for before it switches
+    /// CHR banks or mirroring.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Flush(void);
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Reset the PPU state
     ///
@@ -220,6 +291,44 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     void DoDMA(const Byte* pagePtr);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get a lower bound on the dots left before vertical blank
+    ///
+    /// Counts the Step calls that will complete before the one raising the
+    /// vblank flag (and the NMI). The pre-render line is assumed to be one
+    /// dot short, since the odd-frame skip depends on PPUMASK at that time.
+    ///
+    /// \return The number of dots, zero if the next Step raises the flag
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    int GetDotsUntilVBlank(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the dots left before the PPU does more than count them
+    ///
+    /// Events are the visible dots, where sprite 0 may hit, the vblank flag
+    /// being set and cleared, the scroll copies, the mapper scanline IRQ at
+    /// dot 260, and the ends of lines and frames. No state read through the
+    /// registers changes on the dots in between.
+    ///
+    /// \return The number of dots, zero if the next Step is an event
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    int GetDotsUntilEvent(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the raster position the PPU was at some dots ago
+    ///
+    /// Scanlines are numbered as in nestest logs, the pre-render line being
+    /// 261. Going back across the odd-frame skipped dot is not accounted for.
+    ///
+    /// \param dotsAgo Number of dots to go back, less than a frame
+    /// \param scanline Receives the scanline
+    /// \param dot Receives the dot within the scanline
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void GetPosition(int dotsAgo, int& scanline, int& dot) const;
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Pre-render step
@@ -233,6 +342,69 @@ private:
     ///////////////////////////////////////////////////////////////////////////
     void RenderStep(void);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Draw consecutive pixels of the current scanline
+    /// Registers and PPU memory must not change while the span is drawn.
+    /// The pixels are drawn now if they may hit sprite 0 or the PPU reads
+    /// are monitored, which the CPU can see, and else possibly left for
+    /// Flush.
+    /// \param first Column of the first pixel
+    /// \param count Number of pixels, up to the end of the visible line
+    ///////////////////////////////////////////////////////////////////////////
+    void RenderSpan(int first, int count);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a span into the frame
+    ///
+    /// Only reads the PPU, so spans of other lines may be drawn at the same
+    /// time from other threads.
+    ///
+    /// \param span Span to draw
+    /// \param shared True if other threads draw spans meanwhile
+    ///
+    /// \return True if sprite 0 hit the background
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool DrawSpan(const Span& span, bool shared) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Fetch the background of a span
+    ///
+    /// \param span Span to fetch
+    /// \param shared True if other threads draw spans meanwhile
+    /// \param line Receives the pixels, at the columns of the span
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DrawBackground(const Span& span, bool shared, Byte* line) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the sprites found for the scanline into the line buffer
+    ///
+    /// Called as the scanline starts, like the PPU fetches the sprites of a
+    /// line during the previous one: the pixels then only load the buffer.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DrawSprites(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Add or remove a sprite from the lines it covers
+    ///
+    /// The lines of a sprite are the 8 from its Y on, in m_spriteRows[0],
+    /// and the 8 after that for 8x16 sprites, in m_spriteRows[1]: whatever
+    /// the sprite size, evaluation is a lookup.
+    ///
+    /// \param sprite Index of the sprite in OAM
+    /// \param add True to add the sprite, false to remove it
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void IndexSprite(int sprite, bool add);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Index all the sprites again, after OAM is replaced
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void IndexSprites(void);
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Post-render step
     ///
@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/PPUThread.hpp"
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+PPUThread::PPUThread(PPU& ppu)
+    : m_ppu(ppu)
+    , m_events(QUEUE_SIZE)
+    , m_queued(0)
+    , m_pushed(0)
+    , m_done(0)
+    , m_dmaDone(0)
+    , m_dmaQueued(0)
+    , m_sleeping(false)
+    , m_thread(&PPUThread::Loop, this)
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+PPUThread::~PPUThread()
+{
+    Push({0, STOP, 0});
+    m_thread.join();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPUThread::Run(Uint64 dots)
+{
+    Push({dots, RUN, 0});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPUThread::Write(Uint64 dots, Address address, Byte value)
+{
+    Push({dots, static_cast<Byte>(address & 0x7), value});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPUThread::DMA(Uint64 dots, const Byte* page)
+{
+    // A page is only reused once the DMA that had it is applied
+    while (m_dmaQueued - m_dmaDone.load(std::memory_order_acquire) >=
+        DMA_PAGES)
+    {
+        std::this_thread::yield();
+    }
+
+    Byte slot = static_cast<Byte>(m_dmaQueued++ % DMA_PAGES);
+
+    std::memcpy(m_pages[slot], page, sizeof(m_pages[slot]));
+    Push({dots, OAM_DMA, slot});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPUThread::Wait(void)
+{
+    while (m_done.load(std::memory_order_acquire) != m_queued)
+    {
+        std::this_thread::yield();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPUThread::Push(const Event& event)
+{
+    while (!m_events.Push(event))
+    {
+        // The PPU is a whole queue behind, let it catch up
+        std::this_thread::yield();
+    }
+    m_pushed.store(++m_queued);
+
+    // Either the thread sees the event before sleeping, or it is woken up
+    if (m_sleeping.load())
+    {
+        m_pushed.notify_one();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool PPUThread::Apply(const Event& event)
+{
+    if (event.dots)
+    {
+        m_ppu.Run(event.dots);
+    }
+
+    switch (event.target)
+    {
+    case 0x0:
+        m_ppu.Control(event.value);
+        break;
+    case 0x1:
+        m_ppu.SetMask(event.value);
+        break;
+    case 0x3:
+        m_ppu.SetOAMAddress(event.value);
+        break;
+    case 0x4:
+        m_ppu.SetOAMData(event.value);
+        break;
+    case 0x5:
+        m_ppu.SetScroll(event.value);
+        break;
+    case 0x6:
+        m_ppu.SetDataAddress(event.value);
+        break;
+    case 0x7:
+        m_ppu.SetData(event.value);
+        break;
+    case OAM_DMA:
+        m_ppu.DoDMA(m_pages[event.value]);
+        m_dmaDone.fetch_add(1, std::memory_order_release);
+        break;
+    case STOP:
+        return (false);
+    default:
+        break;
+    }
+    return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PPUThread::Loop(void)
+{
+    Event events[64];
+    int idle = 0;
+
+    while (true)
+    {
+        std::size_t count = m_events.Pop(events, 64);
+
+        if (count == 0)
+        {
+            if (++idle < SPINS)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+
+            // The CPU side may be paused or waiting for real time to pass
+            m_sleeping.store(true);
+            Uint64 pushed = m_pushed.load();
+            if (m_events.IsEmpty())
+            {
+                m_pushed.wait(pushed);
+            }
+            m_sleeping.store(false);
+            continue;
+        }
+        idle = 0;
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (!Apply(events[i]))
+            {
+                m_done.fetch_add(i + 1, std::memory_order_release);
+                return;
+            }
+        }
+        m_done.fetch_add(count, std::memory_order_release);
+    }
+}
+
+} // !namespace NES
@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Audio/RingBuffer.hpp"
+#include "Core/Picture/PPU.hpp"
+#include "Utils.hpp"
+#include <atomic>
+#include <thread>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Thread running the PPU behind the CPU
+///
+/// The CPU side queues how many dots to run and the register writes and
+/// OAM DMAs to apply after them, and carries on; the thread applies them in
+/// order, drawing the frame meanwhile. Anything the CPU reads back from the
+/// PPU, or changes under it like the mapper, needs Wait first: the PPU is
+/// then caught up and idle, and may be used directly until the next event
+/// is queued. There must be a single thread queuing events.
+///
+///////////////////////////////////////////////////////////////////////////////
+class PPUThread
+{
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Work queued for the PPU
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Event
+    {
+        Uint64 dots;    //<! Dots to run first
+        Byte target;    //<! Low bits of a register $2000-$2007, or a Target
+        Byte value;     //<! Value written, or DMA page slot
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Events that are not register writes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum Target : Byte
+    {
+        RUN = 0x8,      //<! Only run the dots
+        OAM_DMA = 0x9,  //<! Copy a page to OAM
+        STOP = 0xA      //<! Run the dots, then end the thread
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private constants
+    ///////////////////////////////////////////////////////////////////////////
+    constexpr static std::size_t QUEUE_SIZE = 4096; //<! Events queued at most
+    constexpr static int DMA_PAGES = 4;             //<! DMAs queued at most
+    constexpr static int SPINS = 256;               //<! Polls before sleeping
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    PPU& m_ppu;                         //<! PPU run by the thread
+    Audio::RingBuffer<Event> m_events;  //<! Events not yet taken
+    Byte m_pages[DMA_PAGES][0x100];     //<! Pages of the DMAs queued
+    Uint64 m_queued;                    //<! Events queued, CPU side only
+    std::atomic<Uint64> m_pushed;       //<! Events queued, for the thread
+    std::atomic<Uint64> m_done;         //<! Events applied
+    std::atomic<Uint64> m_dmaDone;      //<! DMAs applied
+    Uint64 m_dmaQueued;                 //<! DMAs queued, CPU side only
+    std::atomic<bool> m_sleeping;       //<! Thread waits for m_pushed
+    std::thread m_thread;               //<! Thread running the PPU
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start running the PPU on a new thread
+    ///
+    /// \param ppu PPU to run, only used through this object from now on
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    PPUThread(PPU& ppu);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Apply the events left, then end the thread
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    ~PPUThread();
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Queue dots to run
+    ///
+    /// \param dots Number of dots
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Run(Uint64 dots);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Queue a register write
+    ///
+    /// \param dots Number of dots to run before the write
+    /// \param address Register, $2000-$2007
+    /// \param value Value written
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Write(Uint64 dots, Address address, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Queue an OAM DMA
+    ///
+    /// \param dots Number of dots to run before the DMA
+    /// \param page The 256 bytes to copy, which are copied at once
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DMA(Uint64 dots, const Byte* page);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Wait until the PPU has applied all the events queued
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Wait(void);
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Queue an event, waiting for room if the queue is full
+    ///
+    /// \param event Event to queue
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Push(const Event& event);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Apply an event to the PPU
+    ///
+    /// \param event Event to apply
+    ///
+    /// \return False if it was the last event
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool Apply(const Event& event);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Take and apply events until STOP
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Loop(void);
+};
+
+} // !namespace NES
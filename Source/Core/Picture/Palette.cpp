@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/Palette.hpp"
+#include "Core/Colors.hpp"
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+    #define NES_PALETTE_X86
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+static void ExpandScalar(
+    const Uint16* indices,
+    Uint32* pixels,
+    std::size_t count,
+    const Uint32* colors
+)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        pixels[i] = colors[indices[i] & (Palette::COLORS - 1)];
+    }
+}
+
+#ifdef NES_PALETTE_X86
+
+///////////////////////////////////////////////////////////////////////////////
+static void ExpandSSE2(
+    const Uint16* indices,
+    Uint32* pixels,
+    std::size_t count,
+    const Uint32* colors
+)
+{
+    const __m128i mask = _mm_set1_epi16(Palette::COLORS - 1);
+    std::size_t i = 0;
+
+    // SSE2 cannot gather, so only the loads and stores are 8 pixels wide
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i index = _mm_and_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)),
+            mask
+        );
+        __m128i low = _mm_set_epi32(
+            colors[_mm_extract_epi16(index, 3)],
+            colors[_mm_extract_epi16(index, 2)],
+            colors[_mm_extract_epi16(index, 1)],
+            colors[_mm_extract_epi16(index, 0)]
+        );
+        __m128i high = _mm_set_epi32(
+            colors[_mm_extract_epi16(index, 7)],
+            colors[_mm_extract_epi16(index, 6)],
+            colors[_mm_extract_epi16(index, 5)],
+            colors[_mm_extract_epi16(index, 4)]
+        );
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i + 4), high);
+    }
+    ExpandScalar(indices + i, pixels + i, count - i, colors);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+__attribute__((target("avx2")))
+static void ExpandAVX2(
+    const Uint16* indices,
+    Uint32* pixels,
+    std::size_t count,
+    const Uint32* colors
+)
+{
+    const __m256i mask = _mm256_set1_epi32(Palette::COLORS - 1);
+    const int* table = reinterpret_cast<const int*>(colors);
+    std::size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i index = _mm256_and_si256(
+            _mm256_cvtepu16_epi32(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(indices + i)
+            )),
+            mask
+        );
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(pixels + i),
+            _mm256_i32gather_epi32(table, index, 4)
+        );
+    }
+    ExpandScalar(indices + i, pixels + i, count - i, colors);
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+const Uint32* Palette::GetColors(void)
+{
+    static const struct Colors
+    {
+        Uint32 rgba[COLORS];
+
+        Colors(void)
+        {
+            for (int i = 0; i < COLORS; i++)
+            {
+                Uint32 color = NES_COLORS[i & 0x3F];
+                int channels[3] = {
+                    static_cast<int>((color >> 24) & 0xFF),
+                    static_cast<int>((color >> 16) & 0xFF),
+                    static_cast<int>((color >> 8) & 0xFF)
+                };
+
+                // Each emphasized channel (red, green then blue in bits
+                // 6-8) darkens the other two; columns $E and $F are black
+                // and stay so
+                if ((i & 0x0E) != 0x0E)
+                {
+                    for (int c = 0; c < 3; c++)
+                    {
+                        int others = (i >> 6) & ~(1 << c) & 0x7;
+
+                        for (; others != 0; others &= others - 1)
+                        {
+                            channels[c] = channels[c] * 209 / 256;
+                        }
+                    }
+                }
+
+                Byte bytes[4] = {
+                    static_cast<Byte>(channels[0]),
+                    static_cast<Byte>(channels[1]),
+                    static_cast<Byte>(channels[2]),
+                    0xFF
+                };
+
+                std::memcpy(&rgba[i], bytes, sizeof(bytes));
+            }
+        }
+    } colors;
+
+    return (colors.rgba);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Palette::Expand(const Uint16* indices, Byte* pixels, std::size_t count)
+{
+    using Expander = void (*)(const Uint16*, Uint32*, std::size_t,
+        const Uint32*);
+
+#ifdef NES_PALETTE_X86
+    static const Expander expander =
+        __builtin_cpu_supports("avx2") ? ExpandAVX2 : ExpandSSE2;
+#else
+    static const Expander expander = ExpandScalar;
+#endif
+
+    expander(
+        indices, reinterpret_cast<Uint32*>(pixels), count, GetColors()
+    );
+}
+
+} // !namespace NES
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Conversion of the PPU output to RGBA
+///
+/// The PPU outputs one 9-bit index per pixel: the 6-bit color read from
+/// palette RAM in bits 0-5, and the emphasis bits of PPUMASK in bits 6-8.
+/// Turning those into RGBA is left to whoever displays the frame, so that
+/// consumers needing only the indices never pay for it, and others may do
+/// it on another thread: Expand only reads its input and the color table.
+///
+///////////////////////////////////////////////////////////////////////////////
+class Palette
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    // Public constants
+    ///////////////////////////////////////////////////////////////////////////
+    constexpr static int COLORS = 512;  //<! 64 colors times 8 emphasis
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the RGBA value of every index
+    ///
+    /// \return COLORS values, laid out in memory as R, G, B and A bytes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static const Uint32* GetColors(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Convert indices to RGBA pixels
+    ///
+    /// Uses AVX2 gathers when the host supports them, checked once, and
+    /// SSE2 or plain code otherwise.
+    ///
+    /// \param indices Indices output by the PPU
+    /// \param pixels Receives 4 bytes per index, R, G, B and A
+    /// \param count Number of indices
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static void Expand(const Uint16* indices, Byte* pixels, std::size_t count);
+};
+
+} // !namespace NES
@@ -15,7 +15,15 @@ namespace NES
 PictureBus::PictureBus(void)
     : Bus()
     , m_palette(0x20)
+    , m_colors{}
+    , m_colorMask(0x3F)
     , m_ram(0x800)
+    , m_cdl(nullptr)
+    , m_chrAccess(CodeDataLogger::RENDERED)
+    , m_watchRead(0)
+    , m_watchWrite(0)
+    , m_monitored(true)
+    , m_decoded{}
 {
     for (int i = 0; i < 4; i++)
     {
@@ -32,6 +40,15 @@ bool PictureBus::SetMapper(std::shared_ptr<Mapper> mapper)
     }
     m_mapper = mapper;
     UpdateMirroring();
+
+    // CHR ROM never changes, so all of it is decoded up front
+    const Rom<Byte>& chr = m_mapper->GetCartridge().GetCHR();
+
+    m_tiles.SetROM(
+        chr.empty() ? nullptr : chr.data(), chr.size(),
+        TileCache::Decode(chr.data(), chr.size())
+    );
+    UpdateMonitoring();
     return (true);
 }
 
@@ -41,12 +58,40 @@ Byte PictureBus::Read(Address address)
     // Picture bus is limited to 0x3FFF
     address = address & 0X3FFF;
 
+    // No mapper, logging and watches all come down to this one test
+    if (m_monitored)
+    {
+        return (ReadMonitored(address));
+    }
+    return (ReadMemory(address));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Byte PictureBus::ReadMonitored(Address address)
+{
     // Check if the mapper is set
     if (!m_mapper)
     {
         return (0x00);
     }
 
+    if (m_cdl && address < 0x2000)
+    {
+        m_cdl->LogCHR(m_mapper->GetCHROffset(address), m_chrAccess);
+    }
+
+    Byte value = ReadMemory(address);
+
+    if (m_watchRead >> (address >> 10) & 1)
+    {
+        m_watchCallback(address, value, false);
+    }
+    return (value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Byte PictureBus::ReadMemory(Address address)
+{
     // Read from CHR memory
     if (address < 0X2000)
     {
@@ -95,22 +140,61 @@ Byte PictureBus::Read(Address address)
     return (0x00);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+Byte PictureBus::ReadData(Address address)
+{
+    m_chrAccess = CodeDataLogger::READ;
+    Byte value = Read(address);
+    m_chrAccess = CodeDataLogger::RENDERED;
+    return (value);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PictureBus::Write(Address address, Byte value)
 {
     // Picture bus is limited to 0x3FFF
     address = address & 0x3FFF;
 
+    if (m_monitored)
+    {
+        WriteMonitored(address, value);
+    }
+    else
+    {
+        WriteMemory(address, value);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::WriteMonitored(Address address, Byte value)
+{
     // Check if the mapper is set
     if (!m_mapper)
     {
         return;
     }
 
+    WriteMemory(address, value);
+
+    if (m_watchWrite >> (address >> 10) & 1)
+    {
+        m_watchCallback(address, value, true);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::WriteMemory(Address address, Byte value)
+{
     // Write to CHR memory
     if (address < 0x2000)
     {
+        const Byte* page = m_mapper->GetCHRPointer(address & 0x1C00);
+
         m_mapper->WriteCHR(address, value);
+        if (page)
+        {
+            m_tiles.Invalidate(page, (address >> 4) & 0x3F);
+        }
     }
     else if (address < 0x3EFF)
     {
@@ -126,23 +210,16 @@ void PictureBus::Write(Address address, Byte value)
         // Write to the appropriate name table or CHR memory
         if (m_nameTables[0] >= m_ram.size())
         {
+            // Mappers may back these with the pattern table memory
             m_mapper->WriteCHR(address, value);
-        }
-        else if (address < 0x2400)
-        {
-            m_ram[m_nameTables[0] + index] = value;
-        }
-        else if (address < 0x2800)
-        {
-            m_ram[m_nameTables[1] + index] = value;
-        }
-        else if (address < 0x2C00)
-        {
-            m_ram[m_nameTables[2] + index] = value;
+            m_tiles.InvalidateAll();
         }
         else
         {
-            m_ram[m_nameTables[3] + index] = value;
+            size_t offset = m_nameTables[(address >> 10) & 3];
+
+            m_ram[offset + index] = value;
+            DecodeNameTable(offset >> 10, index, value);
         }
     }
     else if (address < 0x3FFF)
@@ -158,6 +235,7 @@ void PictureBus::Write(Address address, Byte value)
 
         // Write the value to the palette
         m_palette[paletteAddress] = value;
+        UpdateColors();
     }
 }
 
@@ -172,6 +250,107 @@ Byte PictureBus::ReadPalette(Byte address)
     return (m_palette[address]);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+const Byte* PictureBus::GetColors(void) const
+{
+    return (m_colors);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::SetGreyscale(bool greyscale)
+{
+    m_colorMask = greyscale ? 0x30 : 0x3F;
+    UpdateColors();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::UpdateColors(void)
+{
+    for (int address = 0; address < 0x20; address++)
+    {
+        m_colors[address] = ReadPalette(address) & m_colorMask;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const TileCache::Tile* PictureBus::GetTile(Address address)
+{
+    const Byte* page =
+        m_monitored ? nullptr : m_mapper->GetCHRPointer(address & 0x1C00);
+
+    if (!page)
+    {
+        return (nullptr);
+    }
+    return (&m_tiles.Get(page, (address >> 4) & 0x3F));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const TileCache::Tile* PictureBus::FindTile(Address address) const
+{
+    const Byte* page =
+        m_monitored ? nullptr : m_mapper->GetCHRPointer(address & 0x1C00);
+
+    if (!page)
+    {
+        return (nullptr);
+    }
+    return (m_tiles.Find(page, (address >> 4) & 0x3F));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::PrepareTiles(void)
+{
+    for (Address address = 0; address < 0x2000; address += 0x10)
+    {
+        GetTile(address);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool PictureBus::IsMonitored(void) const
+{
+    return (m_monitored);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const PictureBus::NameTable* PictureBus::GetNameTable(Address address) const
+{
+    if (m_monitored || m_nameTables[0] >= m_ram.size())
+    {
+        return (nullptr);
+    }
+    return (&m_decoded[m_nameTables[(address >> 10) & 3] >> 10]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::DecodeNameTable(int table, int index, Byte value)
+{
+    NameTable& decoded = m_decoded[table];
+
+    decoded.tiles[index >> 5][index & 0x1F] = value;
+
+    if (index < 0x3C0)
+    {
+        return;
+    }
+
+    // An attribute byte holds the palettes of a 4x4 block of tiles, two
+    // bits per 2x2 quadrant
+    int row = ((index - 0x3C0) >> 3) * 4;
+    int column = (index & 0x07) * 4;
+
+    for (int y = row; y < row + 4; y++)
+    {
+        for (int x = column; x < column + 4; x++)
+        {
+            int shift = ((y & 2) << 1) | (x & 2);
+
+            decoded.palettes[y][x] = ((value >> shift) & 0x3) << 2;
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PictureBus::UpdateMirroring(void)
 {
@@ -229,4 +408,30 @@ void PictureBus::ScanlineIRQ(void)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::SetCodeDataLogger(CodeDataLogger* cdl)
+{
+    m_cdl = cdl;
+    UpdateMonitoring();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::SetWatch(
+    Uint16 read,
+    Uint16 write,
+    std::function<void(Address, Byte, bool)> callback
+)
+{
+    m_watchRead = callback ? read : 0;
+    m_watchWrite = callback ? write : 0;
+    m_watchCallback = std::move(callback);
+    UpdateMonitoring();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void PictureBus::UpdateMonitoring(void)
+{
+    m_monitored = !m_mapper || m_cdl || m_watchRead || m_watchWrite;
+}
+
 } // !namespace NES
@@ -7,6 +7,9 @@
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
 #include "Core/Shared/Bus.hpp"
+#include "Core/Shared/CodeDataLogger.hpp"
+#include "Core/Picture/TileCache.hpp"
+#include <functional>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -26,13 +29,37 @@ namespace NES
 ///////////////////////////////////////////////////////////////////////////////
 class PictureBus : public Bus
 {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Name table decoded for background fetches
+    ///
+    /// Rows 30 and 31 hold the attribute bytes as tiles, as the PPU sees
+    /// them when scrolled there.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct NameTable
+    {
+        Byte tiles[32][32];     //<! Tile index per row and column
+        Byte palettes[32][32];  //<! Palette of each tile, in bits 2-3
+    };
+
 protected:
     ///////////////////////////////////////////////////////////////////////////
     // Protected members
     ///////////////////////////////////////////////////////////////////////////
     size_t m_nameTables[4];         //<! Name tables for the PPU
     std::vector<Byte> m_palette;    //<! Palette for the PPU
+    Byte m_colors[0x20];            //<! Palette as displayed
+    Byte m_colorMask;               //<! Color bits kept, fewer in greyscale
     std::vector<Byte> m_ram;        //<! RAM for the PPU
+    CodeDataLogger* m_cdl;          //<! Logger of CHR ROM use, if any
+    Byte m_chrAccess;               //<! CHRFlag of the reads being made
+    Uint16 m_watchRead;             //<! 1 KB pages with read watches
+    Uint16 m_watchWrite;            //<! 1 KB pages with write watches
+    std::function<void(Address, Byte, bool)> m_watchCallback; //<! Watcher
+    bool m_monitored;               //<! Accesses take the monitored path
+    TileCache m_tiles;              //<! Decoded pattern tables
+    NameTable m_decoded[2];         //<! Decoded copy of each RAM name table
 
 public:
     ///////////////////////////////////////////////////////////////////////////
@@ -58,6 +85,18 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     virtual Byte Read(Address address) override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Read from the PPU memory on behalf of the CPU, via PPUDATA
+    ///
+    /// Same as Read, but logged as a CPU read rather than a tile fetch.
+    ///
+    /// \param address Address to read from
+    ///
+    /// \return The byte read from the PPU memory
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Byte ReadData(Address address);
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Write to the PPU memory
     ///
@@ -87,6 +126,79 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     Byte ReadPalette(Byte address);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the color displayed for each palette address
+    ///
+    /// Kept up to date on palette writes and greyscale changes, so that
+    /// rendering resolves a color with a single load.
+    ///
+    /// \return 32 colors, mirrors and greyscale applied
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Byte* GetColors(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Set whether colors are displayed in greyscale
+    ///
+    /// \param greyscale True to keep only the brightness of colors
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetGreyscale(bool greyscale);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the decoded tile holding a pattern table address
+    ///
+    /// Decoded tiles bypass Read, so none is returned while accesses are
+    /// logged or watched, nor for banks the mapper does not publish.
+    ///
+    /// \param address Address in $0000-$1FFF
+    ///
+    /// \return The tile, or nullptr if it must be read through the bus
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const TileCache::Tile* GetTile(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the decoded tile holding an address, from any thread
+    ///
+    /// Unlike GetTile, never decodes: CHR RAM tiles changed since
+    /// PrepareTiles are not found.
+    ///
+    /// \param address Address in $0000-$1FFF
+    ///
+    /// \return The tile, or nullptr if it must be read through the bus
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const TileCache::Tile* FindTile(Address address) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decode the tiles of the banks mapped, for FindTile
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void PrepareTiles(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check whether reads are logged or watched
+    ///
+    /// \return True if Read may do more than read, and must then be called
+    /// from a single thread
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool IsMonitored(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the decoded name table mapped at an address
+    ///
+    /// Like GetTile, none is returned while accesses are watched, nor for
+    /// four-screen name tables kept by the mapper.
+    ///
+    /// \param address Address in $2000-$2FFF
+    ///
+    /// \return The name table, or nullptr if it must be read through the bus
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const NameTable* GetNameTable(Address address) const;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Update the mirroring of the PPU memory
     ///
@@ -98,6 +210,94 @@ public:
     ///
     ///////////////////////////////////////////////////////////////////////////
     void ScanlineIRQ(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Log the pattern table reads into a Code/Data Logger
+    ///
+    /// \param cdl Logger to mark CHR ROM bytes in, or nullptr to stop
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetCodeDataLogger(CodeDataLogger* cdl);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Watch the reads and writes of some 1 KB pages
+    ///
+    /// Rendering fetches are reported like any other read. While nothing
+    /// is watched or logged, accesses test a single flag and go straight
+    /// to memory.
+    ///
+    /// \param read Pages whose reads are reported, bit n for n * 1 KB on
+    /// \param write Pages whose writes are reported
+    /// \param callback Function receiving the address, the byte read or
+    /// written, and true for a write
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetWatch(
+        Uint16 read,
+        Uint16 write,
+        std::function<void(Address, Byte, bool)> callback
+    );
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Read from the PPU memory, a mapper being set
+    ///
+    /// \param address Address to read from, up to 0x3FFF
+    ///
+    /// \return The byte read from the PPU memory
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Byte ReadMemory(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Read from the PPU memory, logging and reporting the access
+    ///
+    /// \param address Address to read from, up to 0x3FFF
+    ///
+    /// \return The byte read from the PPU memory
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Byte ReadMonitored(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write to the PPU memory, a mapper being set
+    ///
+    /// \param address Address to write to, up to 0x3FFF
+    /// \param value Value to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void WriteMemory(Address address, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write to the PPU memory, reporting the access
+    ///
+    /// \param address Address to write to, up to 0x3FFF
+    /// \param value Value to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void WriteMonitored(Address address, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Update the decoded copy of a name table after a write
+    ///
+    /// \param table Name table written, 0 or 1
+    /// \param index Offset of the byte written in the name table
+    /// \param value Value written
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void DecodeNameTable(int table, int index, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Resolve the displayed colors again
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void UpdateColors(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decide whether accesses need the monitored path
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void UpdateMonitoring(void);
 };
 
 } // !namespace NES
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/TileCache.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+TileCache::TileCache(void)
+    : m_rom(nullptr)
+    , m_romSize(0)
+    , m_lastMemory(nullptr)
+    , m_lastPage(nullptr)
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+std::shared_ptr<const TileCache::Tiles> TileCache::Decode(
+    const Byte* memory,
+    std::size_t size
+)
+{
+    auto tiles = std::make_shared<Tiles>(size / 16);
+
+    for (std::size_t i = 0; i < tiles->size(); i++)
+    {
+        DecodeTile(memory + i * 16, (*tiles)[i]);
+    }
+    return (tiles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TileCache::SetROM(
+    const Byte* rom,
+    std::size_t size,
+    std::shared_ptr<const Tiles> tiles
+)
+{
+    m_rom = rom;
+    m_romSize = rom ? size : 0;
+    m_romTiles = std::move(tiles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::shared_ptr<const TileCache::Tiles> TileCache::GetROMTiles(void) const
+{
+    return (m_romTiles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const TileCache::Tile* TileCache::Find(const Byte* page, int index) const
+{
+    if (page >= m_rom && page < m_rom + m_romSize)
+    {
+        return (&(*m_romTiles)[((page - m_rom) >> 4) + index]);
+    }
+
+    auto found = m_pages.find(page);
+
+    if (found == m_pages.end() || found->second->stale >> index & 1)
+    {
+        return (nullptr);
+    }
+    return (&found->second->tiles[index]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TileCache::Invalidate(const Byte* page, int index)
+{
+    auto found = m_pages.find(page);
+
+    if (found != m_pages.end())
+    {
+        found->second->stale |= Uint64(1) << index;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TileCache::InvalidateAll(void)
+{
+    for (auto& [memory, page] : m_pages)
+    {
+        page->stale = ~Uint64(0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const TileCache::Tile& TileCache::GetRAM(const Byte* page, int index)
+{
+    if (page != m_lastMemory)
+    {
+        std::unique_ptr<Page>& decoded = m_pages[page];
+
+        if (!decoded)
+        {
+            decoded = std::make_unique<Page>();
+            decoded->stale = ~Uint64(0);
+        }
+        m_lastMemory = page;
+        m_lastPage = decoded.get();
+    }
+
+    Tile& tile = m_lastPage->tiles[index];
+
+    if (m_lastPage->stale >> index & 1)
+    {
+        DecodeTile(page + index * 16, tile);
+        m_lastPage->stale &= ~(Uint64(1) << index);
+    }
+    return (tile);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TileCache::DecodeTile(const Byte* planes, Tile& tile)
+{
+    for (int row = 0; row < 8; row++)
+    {
+        DecodeRow(planes[row], planes[row + 8], tile.pixels[row]);
+
+        for (int column = 0; column < 8; column++)
+        {
+            tile.flipped[row][7 - column] = tile.pixels[row][column];
+        }
+    }
+}
+
+} // !namespace NES
@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Cache of pattern table tiles decoded to one color index per pixel
+///
+/// Tiles are found from the CHR memory a mapper publishes for a 1 KB page,
+/// so a bank switch only changes which decoded tiles are looked at and
+/// never invalidates any. CHR ROM is decoded as a whole once, and can be
+/// shared between caches; CHR RAM pages are decoded on first use and a
+/// tile again only after WriteCHR changed it.
+///
+///////////////////////////////////////////////////////////////////////////////
+class TileCache
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Tile decoded from its two bit planes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Tile
+    {
+        Byte pixels[8][8];  //<! Color index 0-3 per row and column
+        Byte flipped[8][8]; //<! The same, mirrored left to right
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decoded tiles of a memory, one per 16 bytes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using Tiles = std::vector<Tile>;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decoded tiles of a 1 KB page of CHR RAM
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Page
+    {
+        Tile tiles[64];     //<! Tiles of the page
+        Uint64 stale;       //<! One bit per tile to decode again
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    const Byte* m_rom;                      //<! CHR ROM, or nullptr
+    std::size_t m_romSize;                  //<! Size of CHR ROM in bytes
+    std::shared_ptr<const Tiles> m_romTiles; //<! Decoded CHR ROM
+    std::unordered_map<const Byte*, std::unique_ptr<Page>> m_pages; //<! RAM
+    const Byte* m_lastMemory;               //<! RAM page looked up last
+    Page* m_lastPage;                       //<! Its decoded tiles
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create an empty cache
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    TileCache(void);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decode every tile of a memory
+    ///
+    /// \param memory Pattern data, a multiple of 16 bytes
+    /// \param size Size of the memory in bytes
+    ///
+    /// \return The decoded tiles
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static std::shared_ptr<const Tiles> Decode(
+        const Byte* memory,
+        std::size_t size
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Set the CHR ROM whose tiles are looked up without decoding
+    ///
+    /// \param rom CHR ROM, or nullptr for a cartridge with CHR RAM
+    /// \param size Size of CHR ROM in bytes
+    /// \param tiles CHR ROM as returned by Decode, possibly shared
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetROM(
+        const Byte* rom,
+        std::size_t size,
+        std::shared_ptr<const Tiles> tiles
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the decoded CHR ROM, to share it with another cache
+    ///
+    /// \return The tiles given to SetROM
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::shared_ptr<const Tiles> GetROMTiles(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get a decoded tile
+    ///
+    /// \param page CHR memory published for a 1 KB page
+    /// \param index Tile within the page, 0 to 63
+    ///
+    /// \return The tile, valid until the next call that changes the cache
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Tile& Get(const Byte* page, int index)
+    {
+        if (page >= m_rom && page < m_rom + m_romSize)
+        {
+            return ((*m_romTiles)[((page - m_rom) >> 4) + index]);
+        }
+        return (GetRAM(page, index));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get a decoded tile without decoding nor caching anything
+    ///
+    /// Safe to call from several threads at once, as long as none changes
+    /// the cache meanwhile.
+    ///
+    /// \param page CHR memory published for a 1 KB page
+    /// \param index Tile within the page, 0 to 63
+    ///
+    /// \return The tile, or nullptr if it is RAM not decoded since changed
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Tile* Find(const Byte* page, int index) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Mark a tile of CHR RAM as changed
+    ///
+    /// \param page CHR memory published for a 1 KB page
+    /// \param index Tile within the page, 0 to 63
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Invalidate(const Byte* page, int index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Mark every tile of CHR RAM as changed
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void InvalidateAll(void);
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get a decoded tile of CHR RAM, decoding it if needed
+    ///
+    /// \param page CHR RAM published for a 1 KB page
+    /// \param index Tile within the page, 0 to 63
+    ///
+    /// \return The tile
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Tile& GetRAM(const Byte* page, int index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decode a tile
+    ///
+    /// \param planes The 16 bytes of the tile
+    /// \param tile Receives the decoded tile
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static void DecodeTile(const Byte* planes, Tile& tile);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decode a row of a tile
+    ///
+    /// \param low Byte of the low bit plane
+    /// \param high Byte of the high bit plane
+    /// \param pixels Receives the 8 color indices, leftmost first
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static void DecodeRow(Byte low, Byte high, Byte* pixels)
+    {
+        for (int column = 0; column < 8; column++)
+        {
+            pixels[column] = ((low >> (7 - column)) & 1) |
+                ((high >> (7 - column)) & 1) << 1;
+        }
+    }
+};
+
+} // !namespace NES
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Picture/WorkerPool.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+WorkerPool::WorkerPool(std::size_t workers)
+    : m_job(nullptr)
+    , m_count(0)
+    , m_next(0)
+    , m_batch(0)
+    , m_working(0)
+    , m_stop(false)
+{
+    for (std::size_t i = 0; i < workers; i++)
+    {
+        m_threads.emplace_back(&WorkerPool::Loop, this);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WorkerPool::Run(std::size_t count, const Job& job)
+{
+    if (m_threads.empty() || count < 2)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_count = count;
+        m_next = 0;
+        m_batch++;
+        m_working = m_threads.size();
+    }
+    m_wake.notify_all();
+
+    Work();
+
+    // Every worker must be done with the batch before it is replaced
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&]()
+    {
+        return (m_working == 0);
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t WorkerPool::GetWorkers(void) const
+{
+    return (m_threads.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WorkerPool::Work(void)
+{
+    for (std::size_t i = m_next++; i < m_count; i = m_next++)
+    {
+        (*m_job)(i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WorkerPool::Loop(void)
+{
+    Uint64 batch = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]()
+            {
+                return (m_stop || m_batch != batch);
+            });
+            if (m_stop)
+            {
+                return;
+            }
+            batch = m_batch;
+        }
+
+        Work();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_working == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
+
+} // !namespace NES
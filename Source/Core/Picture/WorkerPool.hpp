@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Threads sharing out the jobs of a batch
+///
+/// The thread running a batch works on it too, and only returns once every
+/// job is done, so the jobs may use anything that batch's caller owns.
+///
+///////////////////////////////////////////////////////////////////////////////
+class WorkerPool
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Job run for each index of a batch
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using Job = std::function<void(std::size_t)>;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<std::thread> m_threads; //<! Workers
+    std::mutex m_mutex;                 //<! Guards the batch and m_stop
+    std::condition_variable m_wake;     //<! Signals a batch, or m_stop
+    std::condition_variable m_done;     //<! Signals the last worker out
+    const Job* m_job;                   //<! Job of the batch
+    std::size_t m_count;                //<! Jobs of the batch
+    std::atomic<std::size_t> m_next;    //<! Next job to take
+    Uint64 m_batch;                     //<! Number of the batch
+    std::size_t m_working;              //<! Workers not done with it
+    bool m_stop;                        //<! Workers must end
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start the workers
+    ///
+    /// \param workers Number of threads besides the callers of Run
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    WorkerPool(std::size_t workers);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief End the workers
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    ~WorkerPool();
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Run a job for each index from 0 to count - 1
+    ///
+    /// \param count Number of jobs
+    /// \param job Job, called from any thread, in no particular order
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Run(std::size_t count, const Job& job);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the number of workers
+    ///
+    /// \return Threads besides the callers of Run
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t GetWorkers(void) const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Take and run jobs of the batch until there is none left
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Work(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Wait for batches and work on them, until m_stop
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Loop(void);
+};
+
+} // !namespace NES
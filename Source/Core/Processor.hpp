@@ -10,3 +10,6 @@
 #include "Core/Processor/CPU.hpp"
 #include "Core/Processor/OpCodes.hpp"
 #include "Core/Processor/IRQHandler.hpp"
+#include "Core/Processor/Dynarec.hpp"
+#include "Core/Processor/Trace.hpp"
+#include "Core/Processor/Profiler.hpp"
@@ -5,6 +5,8 @@
 #include "Core/Processor/OpCodes.hpp"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <stdexcept>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -14,50 +16,176 @@ namespace NES
 
 ///////////////////////////////////////////////////////////////////////////////
 CPU::CPU(MainBus& bus)
-    : m_pendingNMI(false)
+    : m_skipCycles(0)
+    , m_cycles(0)
+    , m_deadline(0)
+    , m_pendingNMI(false)
     , m_bus(bus)
-    , m_irqPulldowns(0)
-{}
+    , m_irqLines(0)
+    , m_irqCheck(false)
+    , m_nextIRQ(IRQHandler::NEVER)
+    , m_instructions(0)
+    , m_lastBlock(0)
+    , m_idleCycles(0)
+    , m_fusedInstructions(0)
+    , m_trace(nullptr)
+    , m_cdl(nullptr)
+    , m_profiler(nullptr)
+    , m_stepPages(0)
+    , m_watchPages(0)
+{
+    m_irqSchedule.fill(IRQHandler::NEVER);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 void CPU::Step(void)
 {
-    m_cycles++;
-
-    if (m_skipCycles-- > 1)
-    {
-        return;
-    }
-
-    m_skipCycles = 0;
-
     if (m_pendingNMI)
     {
         InterruptSequence(InterruptType::NMI);
         m_pendingNMI = false;
-        return;
     }
     else if (IsPendingIRQ())
     {
         InterruptSequence(InterruptType::IRQ);
-        return;
+    }
+    else if ((m_watchPages >> (r_pc >> 10) & 1) && m_watchCallback(r_pc))
+    {
+        // The instruction runs once emulation resumes
+        EndRun();
+    }
+    else
+    {
+        Address pc = r_pc;
+        Byte opcode = m_bus.Fetch(r_pc++);
+        const Instruction& instruction = InstructionTable[opcode];
+        Address operand = 0;
+
+        if (instruction.length > 1)
+        {
+            operand = m_bus.Fetch(r_pc++);
+        }
+        if (instruction.length > 2)
+        {
+            operand |= m_bus.Fetch(r_pc++) << 8;
+        }
+
+        if (m_trace)
+        {
+            m_trace->Record({
+                m_cycles, pc, opcode,
+                {static_cast<Byte>(operand), static_cast<Byte>(operand >> 8)},
+                r_a, r_x, r_y,
+                static_cast<Byte>(
+                    f_n << 7 | f_v << 6 | 1 << 5 | f_d << 3 | f_i << 2 |
+                    f_z << 1 | f_c
+                ),
+                r_sp, 0, 0
+            });
+        }
+
+        (this->*instruction.execute)(operand);
+        m_skipCycles += instruction.cycles;
+        m_instructions++;
     }
 
-    Byte opcode = m_bus.Read(r_pc++);
-    int cycleLength = OperationCycles[opcode];
+    m_cycles += m_skipCycles;
+    m_skipCycles = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::Run(Uint64 deadline)
+{
+    m_deadline = deadline;
+
+    // Devices may have moved on since the last run, so the loop must be seen
+    // to go round once more before it is known to be idle
+    m_lastBlock = 0;
 
-    if (cycleLength && (
-        ExecuteImplied(opcode) ||
-        ExecuteBranch(opcode) ||
-        ExecuteType1(opcode) ||
-        ExecuteType2(opcode) ||
-        ExecuteType0(opcode)
-    ))
+    while (m_cycles < m_deadline)
     {
-        m_skipCycles += cycleLength;
+        Block* block = nullptr;
+
+        if (m_profiler && m_cycles >= m_profiler->GetNextSample())
+        {
+            m_profiler->Sample(
+                r_pc, m_bus.GetPGROffset(r_pc), r_sp, m_cycles
+            );
+        }
+
+        if (!(m_stepPages >> (r_pc >> 10) & 1) && !m_pendingNMI &&
+            !IsPendingIRQ())
+        {
+            block = FindBlock(r_pc);
+        }
+
+        if (block && block->loopCycles)
+        {
+            RunFusedLoop(*block);
+
+            // A watchpoint may have ended the run inside the loop
+            if (m_cycles >= m_deadline)
+            {
+                break;
+            }
+        }
+
+        if (block && block->idleCycles &&
+            m_lastBlock == block - m_blocks.data() + 1)
+        {
+            // One iteration already ran, and no interrupt can come before
+            // the deadline, so every other one would leave the machine
+            // exactly as it is
+            Uint64 iterations =
+                (m_deadline - 1 - m_cycles) / block->idleCycles;
+
+            m_cycles += iterations * block->idleCycles;
+            m_idleCycles += iterations * block->idleCycles;
+            m_instructions += iterations * block->count;
+        }
+
+        // Idle loops are skipped rather than translated
+        if (block && m_dynarec && !block->code && !block->idleCycles &&
+            ++block->runs == HOT_BLOCK_RUNS)
+        {
+            TranslateBlock(*block);
+        }
+
+        if (block && block->code)
+        {
+            block->code(this);
+        }
+        else if (block)
+        {
+            RunBlock(*block);
+        }
+        else
+        {
+            Step();
+        }
+
+        m_lastBlock = block ? block - m_blocks.data() + 1 : 0;
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void CPU::EndRun(void)
+{
+    m_deadline = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 CPU::GetCycles(void) const
+{
+    return (m_cycles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CPU::IsIRQEnabled(void) const
+{
+    return (!f_i);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void CPU::Reset(void)
 {
@@ -68,12 +196,12 @@ void CPU::Reset(void)
 void CPU::Reset(Address address)
 {
     m_skipCycles = 0;
-    m_cycles = 0;
     r_a = 0; r_x = 0; r_y = 0;
     f_i = true;
     f_c = false; f_d = false; f_n = false; f_v = false; f_z = false;
     r_pc = address;
     r_sp = 0xFD;
+    m_lastBlock = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -82,17 +210,87 @@ Address CPU::GetPC(void)
     return (r_pc);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+CPU::Registers CPU::GetRegisters(void) const
+{
+    Registers registers = {
+        r_pc, r_a, r_x, r_y,
+        static_cast<Byte>(
+            f_n << 7 | f_v << 6 | 1 << 5 | f_d << 3 | f_i << 2 | f_z << 1 | f_c
+        ),
+        r_sp
+    };
+
+    return (registers);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 CPU::GetInstructionCount(void) const
+{
+    return (m_instructions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 CPU::GetIdleCycles(void) const
+{
+    return (m_idleCycles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 CPU::GetFusedInstructionCount(void) const
+{
+    return (m_fusedInstructions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::SetTrace(Trace* trace)
+{
+    m_trace = trace;
+    m_stepPages = (m_trace ? ~Uint64(0) : 0) | m_watchPages;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::SetProfiler(Profiler* profiler)
+{
+    m_profiler = profiler;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::SetExecuteWatch(
+    Uint64 pages,
+    std::function<bool(Address)> callback
+)
+{
+    m_watchPages = callback ? pages : 0;
+    m_watchCallback = std::move(callback);
+    m_stepPages = (m_trace ? ~Uint64(0) : 0) | m_watchPages;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::SetCodeDataLogger(CodeDataLogger* cdl)
+{
+    m_cdl = cdl;
+
+    // Blocks mark their code when decoded, so those already decoded must
+    // be decoded again for the new logger to see them
+    m_blockIndex.clear();
+    m_blocks.clear();
+    m_operations.clear();
+    m_pairs.clear();
+    m_lastBlock = 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void CPU::SkipOAMDMACycles(void)
 {
     m_skipCycles += 513;
-    m_skipCycles += (m_cycles & 1);
+    m_skipCycles += (m_cycles + 1) & 1;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void CPU::SkipDMCDMACycles(void)
 {
-    m_skipCycles += 3;
+    m_cycles += 3;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -104,16 +302,71 @@ void CPU::NMIInterrupt(void)
 ///////////////////////////////////////////////////////////////////////////////
 IRQHandler& CPU::CreateIRQHandler(void)
 {
-    int bit = 1 << m_irqHandlers.size();
-    m_irqHandlers.emplace_back(IRQHandler(bit, *this));
+    int line = static_cast<int>(m_irqHandlers.size());
+
+    if (line == IRQ_LINES)
+    {
+        throw std::runtime_error("No interrupt line left for an IRQ source!");
+    }
+    m_irqHandlers.emplace_back(line, *this);
     return (m_irqHandlers.back());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void CPU::SetIRQPulldown(int bit, bool state)
+void CPU::SetIRQLine(int line, bool state)
+{
+    Byte mask = static_cast<Byte>(1 << line);
+    Byte lines = state ? (m_irqLines | mask) : (m_irqLines & ~mask);
+
+    if (lines != m_irqLines)
+    {
+        m_irqLines = lines;
+        m_irqCheck = true;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::ScheduleIRQ(int line, Uint64 cycle)
+{
+    m_irqSchedule[line] = cycle;
+    m_nextIRQ = *std::min_element(m_irqSchedule.begin(), m_irqSchedule.end());
+    m_deadline = std::min(m_deadline, m_nextIRQ);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 CPU::GetNextIRQ(void) const
+{
+    return (m_nextIRQ);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::SetBackend(CPUBackend backend)
+{
+    if (backend == GetBackend())
+    {
+        return;
+    }
+
+    if (backend == CPUBackend::DYNAREC)
+    {
+        m_dynarec = std::make_unique<Dynarec>();
+    }
+    else
+    {
+        m_dynarec.reset();
+    }
+
+    for (Block& block : m_blocks)
+    {
+        block.runs = 0;
+        block.code = nullptr;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+CPUBackend CPU::GetBackend(void) const
 {
-    int mask = ~(1 << bit);
-    m_irqPulldowns = (m_irqPulldowns & mask) | state;
+    return (m_dynarec ? CPUBackend::DYNAREC : CPUBackend::INTERPRETER);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -151,30 +404,48 @@ void CPU::InterruptSequence(InterruptType type)
         break;
     }
 
+    if (m_profiler)
+    {
+        m_profiler->Call(r_pc, m_bus.GetPGROffset(r_pc), r_sp);
+    }
+
     m_skipCycles += 7;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-bool CPU::ExecuteImplied(Byte opcode)
+template <OperationImplied Operation>
+void CPU::ExecuteImplied(Address operand)
 {
-    switch (static_cast<OperationImplied>(opcode))
+    if constexpr (Operation == OperationImplied::NOP)
+    {
+    }
+    else if constexpr (Operation == OperationImplied::BRK)
     {
-    case OperationImplied::NOP:
-        break;
-    case OperationImplied::BRK:
         InterruptSequence(InterruptType::BRK);
-        break;
-    case OperationImplied::JSR:
-        PushStack(static_cast<Byte>((r_pc + 1) >> 8));
-        PushStack(static_cast<Byte>((r_pc + 1)));
-        r_pc = ReadAddress(r_pc);
-        break;
-    case OperationImplied::RTS:
+    }
+    else if constexpr (Operation == OperationImplied::JSR)
+    {
+        PushStack(static_cast<Byte>((r_pc - 1) >> 8));
+        PushStack(static_cast<Byte>((r_pc - 1)));
+        r_pc = operand;
+
+        if (m_profiler)
+        {
+            m_profiler->Call(r_pc, m_bus.GetPGROffset(r_pc), r_sp);
+        }
+    }
+    else if constexpr (Operation == OperationImplied::RTS)
+    {
         r_pc = PullStack();
         r_pc |= PullStack() << 8;
         r_pc++;
-        break;
-    case OperationImplied::RTI:
+
+        if (m_profiler)
+        {
+            m_profiler->Return(r_sp);
+        }
+    }
+    else if constexpr (Operation == OperationImplied::RTI)
     {
         Byte flags = PullStack();
         f_n = flags & 0x80;
@@ -183,31 +454,41 @@ bool CPU::ExecuteImplied(Byte opcode)
         f_i = flags & 0x4;
         f_z = flags & 0x2;
         f_c = flags & 0x1;
+        m_irqCheck |= !f_i;
         r_pc = PullStack();
         r_pc |= PullStack() << 8;
-        break;
+
+        if (m_profiler)
+        {
+            m_profiler->Return(r_sp);
+        }
     }
-    case OperationImplied::JMP:
-        r_pc = ReadAddress(r_pc);
-        break;
-    case OperationImplied::JMPI:
+    else if constexpr (Operation == OperationImplied::JMP)
+    {
+        r_pc = operand;
+    }
+    else if constexpr (Operation == OperationImplied::JMPI)
     {
-        Address location = ReadAddress(r_pc);
-        Address page = location & 0xFF00;
+        Address page = operand & 0xFF00;
         r_pc =
-            m_bus.Read(location) |
-            m_bus.Read(page | ((location + 1) & 0xff)) << 8;
-        break;
+            m_bus.Read(operand) |
+            m_bus.Read(page | ((operand + 1) & 0xff)) << 8;
+
+        if (m_cdl)
+        {
+            m_cdl->LogPGR(
+                m_bus.GetPGROffset(r_pc), r_pc, CodeDataLogger::INDIRECT_CODE
+            );
+        }
     }
-    case OperationImplied::PHP:
+    else if constexpr (Operation == OperationImplied::PHP)
     {
         Byte flags =
             f_n << 7 | f_v << 6 | 1 << 5 | 1 << 4 |
             f_d << 3 | f_i << 2 | f_z << 1 | f_c;
         PushStack(flags);
-        break;
     }
-    case OperationImplied::PLP:
+    else if constexpr (Operation == OperationImplied::PLP)
     {
         Byte flags = PullStack();
         f_n = flags & 0x80;
@@ -216,467 +497,1003 @@ bool CPU::ExecuteImplied(Byte opcode)
         f_i = flags & 0x4;
         f_z = flags & 0x2;
         f_c = flags & 0x1;
-        break;
+        m_irqCheck |= !f_i;
     }
-    case OperationImplied::PHA:
+    else if constexpr (Operation == OperationImplied::PHA)
+    {
         PushStack(r_a);
-        break;
-    case OperationImplied::PLA:
+    }
+    else if constexpr (Operation == OperationImplied::PLA)
+    {
         r_a = PullStack();
         SetZN(r_a);
-        break;
-    case OperationImplied::DEY:
+    }
+    else if constexpr (Operation == OperationImplied::DEY)
+    {
         r_y--;
         SetZN(r_y);
-        break;
-    case OperationImplied::DEX:
+    }
+    else if constexpr (Operation == OperationImplied::DEX)
+    {
         r_x--;
         SetZN(r_x);
-        break;
-    case OperationImplied::TAY:
+    }
+    else if constexpr (Operation == OperationImplied::TAY)
+    {
         r_y = r_a;
         SetZN(r_y);
-        break;
-    case OperationImplied::INY:
+    }
+    else if constexpr (Operation == OperationImplied::INY)
+    {
         r_y++;
         SetZN(r_y);
-        break;
-    case OperationImplied::INX:
+    }
+    else if constexpr (Operation == OperationImplied::INX)
+    {
         r_x++;
         SetZN(r_x);
-        break;
-    case OperationImplied::CLC:
+    }
+    else if constexpr (Operation == OperationImplied::CLC)
+    {
         f_c = false;
-        break;
-    case OperationImplied::SEC:
+    }
+    else if constexpr (Operation == OperationImplied::SEC)
+    {
         f_c = true;
-        break;
-    case OperationImplied::CLI:
+    }
+    else if constexpr (Operation == OperationImplied::CLI)
+    {
         f_i = false;
-        break;
-    case OperationImplied::SEI:
+        m_irqCheck = true;
+    }
+    else if constexpr (Operation == OperationImplied::SEI)
+    {
         f_i = true;
-        break;
-    case OperationImplied::CLD:
+    }
+    else if constexpr (Operation == OperationImplied::CLD)
+    {
         f_d = false;
-        break;
-    case OperationImplied::SED:
+    }
+    else if constexpr (Operation == OperationImplied::SED)
+    {
         f_d = true;
-        break;
-    case OperationImplied::TYA:
+    }
+    else if constexpr (Operation == OperationImplied::TYA)
+    {
         r_a = r_y;
         SetZN(r_a);
-        break;
-    case OperationImplied::CLV:
+    }
+    else if constexpr (Operation == OperationImplied::CLV)
+    {
         f_v = false;
-        break;
-    case OperationImplied::TXA:
+    }
+    else if constexpr (Operation == OperationImplied::TXA)
+    {
         r_a = r_x;
         SetZN(r_a);
-        break;
-    case OperationImplied::TXS:
+    }
+    else if constexpr (Operation == OperationImplied::TXS)
+    {
         r_sp = r_x;
-        break;
-    case OperationImplied::TAX:
+    }
+    else if constexpr (Operation == OperationImplied::TAX)
+    {
         r_x = r_a;
         SetZN(r_x);
-        break;
-    case OperationImplied::TSX:
+    }
+    else if constexpr (Operation == OperationImplied::TSX)
+    {
         r_x = r_sp;
         SetZN(r_x);
-        break;
-    default:
-        return (false);
     }
-    return (true);
+    NES_UNUSED(operand);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-bool CPU::ExecuteBranch(Byte opcode)
+template <BranchOnFlag Flag, bool Condition>
+void CPU::ExecuteBranch(Address operand)
 {
-    if ((opcode & BRANCH_INSTRUCTION_MASK) == BRANCH_INSTRUCTION_MASK_RESULT)
-    {
-        bool branch = opcode & BRANCH_CONDITION_MASK;
-
-        switch (static_cast<BranchOnFlag>(opcode >> BRANCH_ON_FLAG_SHIFT))
-        {
-        case BranchOnFlag::NEGATIVE:
-            branch = !(branch ^ f_n);
-            break;
-        case BranchOnFlag::OVERFLOW:
-            branch = !(branch ^ f_v);
-            break;
-        case BranchOnFlag::CARRY:
-            branch = !(branch ^ f_c);
-            break;
-        case BranchOnFlag::ZERO:
-            branch = !(branch ^ f_z);
-            break;
-        default:
-            return (false);
-        };
+    bool flag = false;
 
-        if (branch)
-        {
-            Int8 offset = m_bus.Read(r_pc++);
-            m_skipCycles++;
-            Address newPC = static_cast<Address>(r_pc + offset);
-            SkipPageCrossCycle(r_pc, newPC);
-            r_pc = newPC;
-        }
-        else
-        {
-            r_pc++;
-        }
+    if constexpr (Flag == BranchOnFlag::NEGATIVE)
+    {
+        flag = f_n;
+    }
+    else if constexpr (Flag == BranchOnFlag::OVERFLOW)
+    {
+        flag = f_v;
+    }
+    else if constexpr (Flag == BranchOnFlag::CARRY)
+    {
+        flag = f_c;
+    }
+    else if constexpr (Flag == BranchOnFlag::ZERO)
+    {
+        flag = f_z;
+    }
 
-        return (true);
+    if (flag == Condition)
+    {
+        Int8 offset = static_cast<Int8>(operand);
+        m_skipCycles++;
+        Address newPC = static_cast<Address>(r_pc + offset);
+        SkipPageCrossCycle(r_pc, newPC);
+        r_pc = newPC;
     }
-    return (false);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-bool CPU::ExecuteType0(Byte opcode)
+template <Operation0 Operation, AddrMode2 Mode, bool PageCross>
+void CPU::ExecuteType0(Address operand)
 {
-    if ((opcode & INSTRUCTION_MODE_MASK) == 0x0)
+    Address location = 0;
+
+    if constexpr (Mode == AddrMode2::IMMEDIATE)
+    {
+        location = r_pc - 1;
+    }
+    else if constexpr (Mode == AddrMode2::INDEXED)
+    {
+        location = (operand + r_x) & 0xFF;
+    }
+    else if constexpr (Mode == AddrMode2::ABSOLUTE_INDEXED)
+    {
+        location = IndexAddress<PageCross>(operand, r_x);
+    }
+    else
+    {
+        location = operand;
+    }
+
+    if constexpr (Operation == Operation0::BIT)
+    {
+        Byte value = m_bus.Read(location);
+        f_z = !(r_a & value);
+        f_v = value & 0x40;
+        f_n = value & 0x80;
+    }
+    else if constexpr (Operation == Operation0::STY)
+    {
+        m_bus.Write(location, r_y);
+    }
+    else if constexpr (Operation == Operation0::LDY)
+    {
+        r_y = m_bus.Read(location);
+        SetZN(r_y);
+    }
+    else if constexpr (Operation == Operation0::CPY)
+    {
+        Uint16 diff = r_y - m_bus.Read(location);
+        f_c = !(diff & 0x100);
+        SetZN(diff);
+    }
+    else if constexpr (Operation == Operation0::CPX)
+    {
+        Uint16 diff = r_x - m_bus.Read(location);
+        f_c = !(diff & 0x100);
+        SetZN(diff);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <Operation1 Operation, AddrMode1 Mode, bool PageCross>
+void CPU::ExecuteType1(Address operand)
+{
+    Address location = 0;
+
+    if constexpr (Mode == AddrMode1::INDEXED_INDIRECT_X)
+    {
+        Byte zpAddress = r_x + operand;
+        location = m_bus.Read(zpAddress & 0xff) |
+            m_bus.Read((zpAddress + 1) & 0xff) << 8;
+    }
+    else if constexpr (Mode == AddrMode1::IMMEDIATE)
     {
-        Address location = 0;
-        AddrMode2 mode = static_cast<AddrMode2>(
-            (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT);
+        location = r_pc - 1;
+    }
+    else if constexpr (Mode == AddrMode1::INDIRECT_Y)
+    {
+        location = m_bus.Read(operand & 0xff) |
+            m_bus.Read((operand + 1) & 0xff) << 8;
+        location = IndexAddress<PageCross>(location, r_y);
+    }
+    else if constexpr (Mode == AddrMode1::INDEXED_X)
+    {
+        location = (operand + r_x) & 0xFF;
+    }
+    else if constexpr (Mode == AddrMode1::ABSOLUTE_Y)
+    {
+        location = IndexAddress<PageCross>(operand, r_y);
+    }
+    else if constexpr (Mode == AddrMode1::ABSOLUTE_X)
+    {
+        location = IndexAddress<PageCross>(operand, r_x);
+    }
+    else
+    {
+        location = operand;
+    }
 
-        switch (mode)
+    if constexpr (
+        Mode == AddrMode1::INDEXED_INDIRECT_X || Mode == AddrMode1::INDIRECT_Y
+    )
+    {
+        if (m_cdl)
         {
-        case AddrMode2::IMMEDIATE:
-            location = r_pc++;
-            break;
-        case AddrMode2::ZERO_PAGE:
-            location = m_bus.Read(r_pc++);
-            break;
-        case AddrMode2::ABSOLUTE:
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            break;
-        case AddrMode2::INDEXED:
-            location = (m_bus.Read(r_pc++) + r_x) & 0xFF;
-            break;
-        case AddrMode2::ABSOLUTE_INDEXED:
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            SkipPageCrossCycle(location, location + r_x);
-            location += r_x;
-            break;
-        default:
-            return (false);
+            m_cdl->LogPGR(
+                m_bus.GetPGROffset(location), location,
+                CodeDataLogger::INDIRECT_DATA
+            );
         }
+    }
+
+    if constexpr (Operation == Operation1::ORA)
+    {
+        r_a |= m_bus.Read(location);
+        SetZN(r_a);
+    }
+    else if constexpr (Operation == Operation1::AND)
+    {
+        r_a &= m_bus.Read(location);
+        SetZN(r_a);
+    }
+    else if constexpr (Operation == Operation1::EOR)
+    {
+        r_a ^= m_bus.Read(location);
+        SetZN(r_a);
+    }
+    else if constexpr (Operation == Operation1::ADC)
+    {
+        Byte value = m_bus.Read(location);
+        Uint16 sum = r_a + value + f_c;
+        f_c = sum & 0x100;
+        f_v = (r_a ^ sum) & (value ^ sum) & 0x80;
+        r_a = static_cast<Byte>(sum);
+        SetZN(r_a);
+    }
+    else if constexpr (Operation == Operation1::STA)
+    {
+        m_bus.Write(location, r_a);
+    }
+    else if constexpr (Operation == Operation1::LDA)
+    {
+        r_a = m_bus.Read(location);
+        SetZN(r_a);
+    }
+    else if constexpr (Operation == Operation1::SBC)
+    {
+        Uint16 subtrahend = m_bus.Read(location);
+        Uint16 diff = r_a - subtrahend - !f_c;
+        f_c = !(diff & 0x100);
+        f_v = (r_a ^ diff) & (~subtrahend ^ diff) & 0x80;
+        r_a = diff;
+        SetZN(diff);
+    }
+    else if constexpr (Operation == Operation1::CMP)
+    {
+        Uint16 diff = r_a - m_bus.Read(location);
+        f_c = !(diff & 0x100);
+        SetZN(diff);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <Operation2 Operation, AddrMode2 Mode, bool PageCross>
+void CPU::ExecuteType2(Address operand)
+{
+    constexpr bool indexY =
+        Operation == Operation2::LDX || Operation == Operation2::STX;
+    Address location = 0;
+
+    if constexpr (Mode == AddrMode2::IMMEDIATE)
+    {
+        location = r_pc - 1;
+    }
+    else if constexpr (Mode == AddrMode2::INDEXED)
+    {
+        location = (operand + (indexY ? r_y : r_x)) & 0xFF;
+    }
+    else if constexpr (Mode == AddrMode2::ABSOLUTE_INDEXED)
+    {
+        location = IndexAddress<PageCross>(operand, indexY ? r_y : r_x);
+    }
+    else
+    {
+        location = operand;
+    }
 
-        Uint16 operand = 0;
-        Operation0 operation = static_cast<Operation0>(
-            (opcode & OPERATION_MASK) >> OPERATION_SHIFT);
+    if constexpr (
+        Operation == Operation2::ASL || Operation == Operation2::ROL
+    )
+    {
+        bool prev_c = f_c;
+        bool carryIn = prev_c && (Operation == Operation2::ROL);
 
-        switch (operation)
+        if constexpr (Mode == AddrMode2::ACCUMULATOR)
         {
-        case Operation0::BIT:
-            operand = m_bus.Read(location);
-            f_z = !(r_a & operand);
-            f_v = operand & 0x40;
-            f_n = operand & 0x80;
-            break;
-        case Operation0::STY:
-            m_bus.Write(location, r_y);
-            break;
-        case Operation0::LDY:
-            r_y = m_bus.Read(location);
-            SetZN(r_y);
-            break;
-        case Operation0::CPY:
+            f_c = r_a & 0x80;
+            r_a <<= 1;
+            r_a = r_a | carryIn;
+            SetZN(r_a);
+        }
+        else
         {
-            Uint16 diff = r_y - m_bus.Read(location);
-            f_c = !(diff & 0x100);
-            SetZN(diff);
-            break;
+            Uint16 value = m_bus.Read(location);
+            f_c = value & 0x80;
+            value = value << 1 | carryIn;
+            SetZN(value);
+            m_bus.Write(location, value);
         }
-        case Operation0::CPX:
+    }
+    else if constexpr (
+        Operation == Operation2::LSR || Operation == Operation2::ROR
+    )
+    {
+        bool prev_c = f_c;
+        bool carryIn = prev_c && (Operation == Operation2::ROR);
+
+        if constexpr (Mode == AddrMode2::ACCUMULATOR)
         {
-            Uint16 diff = r_x - m_bus.Read(location);
-            f_c = !(diff & 0x100);
-            SetZN(diff);
-            break;
+            f_c = r_a & 1;
+            r_a >>= 1;
+            r_a = r_a | carryIn << 7;
+            SetZN(r_a);
         }
-        default:
-            return (false);
+        else
+        {
+            Uint16 value = m_bus.Read(location);
+            f_c = value & 1;
+            value = value >> 1 | carryIn << 7;
+            SetZN(value);
+            m_bus.Write(location, value);
         }
+    }
+    else if constexpr (Operation == Operation2::STX)
+    {
+        m_bus.Write(location, r_x);
+    }
+    else if constexpr (Operation == Operation2::LDX)
+    {
+        r_x = m_bus.Read(location);
+        SetZN(r_x);
+    }
+    else if constexpr (Operation == Operation2::DEC)
+    {
+        Byte tmp = m_bus.Read(location) - 1;
+        SetZN(tmp);
+        m_bus.Write(location, tmp);
+    }
+    else if constexpr (Operation == Operation2::INC)
+    {
+        Byte tmp = m_bus.Read(location) + 1;
+        SetZN(tmp);
+        m_bus.Write(location, tmp);
+    }
+}
 
-        return (true);
+///////////////////////////////////////////////////////////////////////////////
+void CPU::ExecuteInvalid(Address operand)
+{
+    NES_UNUSED(operand);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+CPU::Block* CPU::FindBlock(Address address)
+{
+    Int32 offset = m_bus.GetPGROffset(address);
+
+    if (offset < 0)
+    {
+        return (nullptr);
     }
-    return (false);
+
+    if (static_cast<std::size_t>(offset) >= m_blockIndex.size())
+    {
+        m_blockIndex.resize((offset | 0x3FFF) + 1, 0);
+    }
+
+    if (m_blockIndex[offset] == 0)
+    {
+        m_blockIndex[offset] = DecodeBlock(address);
+    }
+
+    Block& block = m_blocks[m_blockIndex[offset] - 1];
+
+    if (block.count == 0)
+    {
+        // The first instruction straddles the page end
+        return (nullptr);
+    }
+    return (&block);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-bool CPU::ExecuteType1(Byte opcode)
+Uint32 CPU::DecodeBlock(Address address)
 {
-    if ((opcode & INSTRUCTION_MODE_MASK) == 0x1)
+    const Byte* code = m_bus.GetPGRPointer(address);
+    int size = 0x400 - (address & 0x3FF);
+    Block block = {
+        static_cast<Uint32>(m_operations.size()), 0, 0, nullptr, 0, 0
+    };
+    int i = 0;
+
+    while (i < size)
     {
-        Address location = 0;
-        Operation1 operation = static_cast<Operation1>(
-            (opcode & OPERATION_MASK) >> OPERATION_SHIFT);
-        AddrMode1 mode = static_cast<AddrMode1>(
-            (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT);
+        Byte opcode = code[i];
+        const Instruction& instruction = InstructionTable[opcode];
+        Address operand = 0;
 
-        switch (mode)
-        {
-        case AddrMode1::INDEXED_INDIRECT_X:
+        if (i + instruction.length > size)
         {
-            Byte zpAddress = r_x + m_bus.Read(r_pc++);
-            location = m_bus.Read(zpAddress & 0xff) |
-                m_bus.Read((zpAddress + 1) & 0xff) << 8;
             break;
         }
-        case AddrMode1::ZERO_PAGE:
-            location = m_bus.Read(r_pc++);
-            break;
-        case AddrMode1::IMMEDIATE:
-            location = r_pc++;
-            break;
-        case AddrMode1::ABSOLUTE:
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            break;
-        case AddrMode1::INDIRECT_Y:
+        if (instruction.length > 1)
         {
-            Byte zpAddress = m_bus.Read(r_pc++);
-            location = m_bus.Read(zpAddress & 0xff) |
-                m_bus.Read((zpAddress + 1) & 0xff) << 8;
-            if (operation != Operation1::STA)
-            {
-                SkipPageCrossCycle(location, location + r_y);
-            }
-            location += r_y;
-            break;
+            operand = code[i + 1];
         }
-        case AddrMode1::INDEXED_X:
-            location = (m_bus.Read(r_pc++) + r_x) & 0xFF;
-            break;
-        case AddrMode1::ABSOLUTE_Y:
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            if (operation != Operation1::STA)
-            {
-                SkipPageCrossCycle(location, location + r_y);
-            }
-            location += r_y;
-            break;
-        case AddrMode1::ABSOLUTE_X:
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            if (operation != Operation1::STA)
-            {
-                SkipPageCrossCycle(location, location + r_x);
-            }
-            location += r_x;
-            break;
-        default:
-            return (false);
+        if (instruction.length > 2)
+        {
+            operand |= code[i + 2] << 8;
         }
 
-        switch (operation)
+        Operation operation = {
+            instruction.execute,
+            operand,
+            opcode,
+            instruction.length,
+            instruction.cycles,
+            false
+        };
+
+        i += instruction.length;
+
+        if (block.count > 0 && FusePair(m_operations.back(), operation))
         {
-        case Operation1::ORA:
-            r_a |= m_bus.Read(location);
-            SetZN(r_a);
-            break;
-        case Operation1::AND:
-            r_a &= m_bus.Read(location);
-            SetZN(r_a);
-            break;
-        case Operation1::EOR:
-            r_a ^= m_bus.Read(location);
-            SetZN(r_a);
-            break;
-        case Operation1::ADC:
+            continue;
+        }
+        m_operations.push_back(operation);
+        block.count++;
+
+        if (EndsBasicBlock(opcode))
         {
-            Byte operand = m_bus.Read(location);
-            Uint16 sum = r_a + operand + f_c;
-            f_c = sum & 0x100;
-            f_v = (r_a ^ sum) & (operand ^ sum) & 0x80;
-            r_a = static_cast<Byte>(sum);
-            SetZN(r_a);
             break;
         }
-        case Operation1::STA:
-            m_bus.Write(location, r_a);
-            break;
-        case Operation1::LDA:
-            r_a = m_bus.Read(location);
-            SetZN(r_a);
-            break;
-        case Operation1::SBC:
-        {
-            Uint16 subtrahend = m_bus.Read(location);
-            Uint16 diff = r_a - subtrahend - !f_c;
-            f_c = !(diff & 0x100);
-            f_v = (r_a ^ diff) & (~subtrahend ^ diff) & 0x80;
-            r_a = diff;
-            SetZN(diff);
-            break;
+    }
+
+    if (m_cdl)
+    {
+        Int32 offset = m_bus.GetPGROffset(address);
+
+        // Every instruction of a basic block runs once its first one does
+        for (int byte = 0; byte < i; byte++)
+        {
+            m_cdl->LogPGR(
+                offset + byte, address + byte, CodeDataLogger::CODE
+            );
         }
-        case Operation1::CMP:
+    }
+
+    block.idleCycles = GetIdleLoopCycles(address, block);
+    block.loopCycles = GetFusedLoopCycles(address, block);
+    m_blocks.push_back(block);
+    return (static_cast<Uint32>(m_blocks.size()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint32 CPU::GetIdleLoopCycles(Address address, const Block& block) const
+{
+    if (block.count == 0)
+    {
+        return (0);
+    }
+
+    const Operation* operations = &m_operations[block.first];
+    const Operation& last = operations[block.count - 1];
+    Address end = address;
+    Address target = 0;
+    Uint32 cycles = 0;
+
+    for (Uint32 i = 0; i < block.count; i++)
+    {
+        end += operations[i].length;
+        cycles += operations[i].cycles;
+    }
+
+    if (last.opcode == static_cast<Byte>(OperationImplied::JMP))
+    {
+        target = last.operand;
+    }
+    else if (GetInstructionType(last.opcode) == InstructionType::BRANCH)
+    {
+        target = end + static_cast<Int8>(last.operand);
+        cycles += 1 + ((end & 0xFF00) != (target & 0xFF00));
+    }
+
+    if (target != address)
+    {
+        return (0);
+    }
+
+    // LDA/BIT $2002 then BPL: the N flag is the vblank flag, which cannot
+    // rise before the deadline. BMI is left out, as the read clears the flag
+    // and the loop exits on its next pass
+    if (block.count == 2 && operations[0].operand == MainBus::PPU_STATUS &&
+        (operations[0].opcode == 0xAD || operations[0].opcode == 0x2C) &&
+        static_cast<BranchOnFlag>(last.opcode >> BRANCH_ON_FLAG_SHIFT) ==
+            BranchOnFlag::NEGATIVE &&
+        (last.opcode & BRANCH_CONDITION_MASK) == 0 &&
+        GetInstructionType(last.opcode) == InstructionType::BRANCH)
+    {
+        return (cycles);
+    }
+
+    for (Uint32 i = 0; i + 1 < block.count; i++)
+    {
+        if (!IsIdleOperation(operations[i]))
         {
-            Uint16 diff = r_a - m_bus.Read(location);
-            f_c = !(diff & 0x100);
-            SetZN(diff);
-            break;
+            return (0);
         }
+    }
+    return (cycles);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CPU::IsIdleOperation(const Operation& operation)
+{
+    if (operation.fused)
+    {
+        return (false);
+    }
+
+    Byte opcode = operation.opcode;
+    int kind = (opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+    int mode = (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+    bool immediate = false;
+
+    switch (GetInstructionType(opcode))
+    {
+    case InstructionType::IMPLIED:
+        switch (static_cast<OperationImplied>(opcode))
+        {
+        case OperationImplied::NOP:
+        case OperationImplied::CLC:
+        case OperationImplied::SEC:
+        case OperationImplied::CLV:
+        case OperationImplied::CLD:
+        case OperationImplied::SED:
+            return (true);
         default:
             return (false);
         }
+    case InstructionType::TYPE0:
+        if (static_cast<Operation0>(kind) == Operation0::STY)
+        {
+            return (false);
+        }
+        immediate = static_cast<AddrMode2>(mode) == AddrMode2::IMMEDIATE;
+        break;
+    case InstructionType::TYPE1:
+        // EOR, ADC and SBC do not reach a fixed point, STA writes
+        if (static_cast<Operation1>(kind) != Operation1::ORA &&
+            static_cast<Operation1>(kind) != Operation1::AND &&
+            static_cast<Operation1>(kind) != Operation1::LDA &&
+            static_cast<Operation1>(kind) != Operation1::CMP)
+        {
+            return (false);
+        }
+        immediate = static_cast<AddrMode1>(mode) == AddrMode1::IMMEDIATE;
+        break;
+    case InstructionType::TYPE2:
+        if (static_cast<Operation2>(kind) != Operation2::LDX)
+        {
+            return (false);
+        }
+        immediate = static_cast<AddrMode2>(mode) == AddrMode2::IMMEDIATE;
+        break;
+    default:
+        return (false);
+    }
 
+    if (immediate)
+    {
         return (true);
     }
-    return (false);
+    if (static_cast<AddrMode2>(mode) != AddrMode2::ZERO_PAGE &&
+        static_cast<AddrMode2>(mode) != AddrMode2::ABSOLUTE)
+    {
+        return (false);
+    }
+
+    // Internal RAM, cartridge RAM and ROM, but no register
+    return (operation.operand < 0x2000 || operation.operand >= 0x6000);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-bool CPU::ExecuteType2(Byte opcode)
+Uint32 CPU::GetFusedLoopCycles(Address address, const Block& block) const
 {
-    if ((opcode & INSTRUCTION_MODE_MASK) == 2)
+    if (block.count < 2)
     {
-        Address location = 0;
-        Operation2 operation = static_cast<Operation2>(
-            (opcode & OPERATION_MASK) >> OPERATION_SHIFT);
-        AddrMode2 mode = static_cast<AddrMode2>(
-            (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT);
+        return (0);
+    }
 
-        switch (mode)
-        {
-        case AddrMode2::IMMEDIATE:
-            location = r_pc++;
-            break;
-        case AddrMode2::ZERO_PAGE:
-            location = m_bus.Read(r_pc++);
-            break;
-        case AddrMode2::ACCUMULATOR:
-            break;
-        case AddrMode2::ABSOLUTE:
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            break;
-        case AddrMode2::INDEXED:
-        {
-            location = m_bus.Read(r_pc++);
-            Byte index;
+    const Operation* operations = &m_operations[block.first];
+    const Operation& last = operations[block.count - 1];
+    auto step =
+        static_cast<OperationImplied>(operations[block.count - 2].opcode);
+    Address end = address;
+    Uint32 cycles = 0;
 
-            if (operation == Operation2::LDX || operation == Operation2::STX)
-            {
-                index = r_y;
-            }
-            else
-            {
-                index = r_x;
-            }
+    for (Uint32 i = 0; i < block.count; i++)
+    {
+        end += operations[i].length;
+        cycles += operations[i].cycles;
+    }
 
-            location = (location + index) & 0xFF;
-            break;
+    // BNE back to the first store
+    Address target = end + static_cast<Int8>(last.operand);
+
+    if (GetInstructionType(last.opcode) != InstructionType::BRANCH ||
+        static_cast<BranchOnFlag>(last.opcode >> BRANCH_ON_FLAG_SHIFT) !=
+            BranchOnFlag::ZERO ||
+        (last.opcode & BRANCH_CONDITION_MASK) != 0 || target != address)
+    {
+        return (0);
+    }
+
+    if (step != OperationImplied::INX && step != OperationImplied::DEX &&
+        step != OperationImplied::INY && step != OperationImplied::DEY)
+    {
+        return (0);
+    }
+
+    for (Uint32 i = 0; i + 2 < block.count; i++)
+    {
+        Byte opcode = operations[i].opcode;
+        int kind = (opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+
+        if (operations[i].fused ||
+            GetInstructionType(opcode) != InstructionType::TYPE1 ||
+            static_cast<Operation1>(kind) != Operation1::STA ||
+            !IsPlainMemoryAccess(operations[i]))
+        {
+            return (0);
         }
-        case AddrMode2::ABSOLUTE_INDEXED:
+    }
+    return (cycles + 1 + ((end & 0xFF00) != (target & 0xFF00)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CPU::IsPlainMemoryAccess(const Operation& operation)
+{
+    int mode = (operation.opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+    Uint32 first = operation.operand;
+    Uint32 last = operation.operand;
+
+    if (GetInstructionType(operation.opcode) != InstructionType::TYPE1)
+    {
+        return (false);
+    }
+
+    switch (static_cast<AddrMode1>(mode))
+    {
+    case AddrMode1::IMMEDIATE:
+    case AddrMode1::ZERO_PAGE:
+    case AddrMode1::INDEXED_X:
+        // Zero page indexing wraps inside internal RAM
+        return (true);
+    case AddrMode1::ABSOLUTE:
+        break;
+    case AddrMode1::ABSOLUTE_X:
+    case AddrMode1::ABSOLUTE_Y:
+        last += 0xFF;
+        break;
+    default:
+        // The pointer is only known at run time
+        return (false);
+    }
+
+    if (WritesOperand(operation.opcode))
+    {
+        // Internal or cartridge RAM, never a mapper register
+        return (last < 0x2000 || (first >= 0x6000 && last < 0x8000));
+    }
+    return (last < 0x2000 || (first >= 0x4020 && last <= 0xFFFF));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CPU::FusePair(Operation& load, const Operation& store)
+{
+    auto loadIt = std::find(FUSED_LOADS.begin(), FUSED_LOADS.end(),
+        load.opcode);
+    auto storeIt = std::find(FUSED_STORES.begin(), FUSED_STORES.end(),
+        store.opcode);
+
+    if (load.fused || loadIt == FUSED_LOADS.end() ||
+        storeIt == FUSED_STORES.end() || m_pairs.size() > 0xFFFF ||
+        !IsPlainMemoryAccess(load) || !IsPlainMemoryAccess(store))
+    {
+        return (false);
+    }
+
+    std::size_t index =
+        (loadIt - FUSED_LOADS.begin()) * FUSED_STORES.size() +
+        (storeIt - FUSED_STORES.begin());
+
+    m_pairs.push_back({load, store});
+    load.execute = PairTable[index];
+    load.operand = static_cast<Address>(m_pairs.size() - 1);
+    load.length += store.length;
+    load.cycles += store.cycles;
+    load.fused = true;
+    return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::RunFusedLoop(const Block& block)
+{
+    const Operation* operations = &m_operations[block.first];
+    Uint32 stores = block.count - 2;
+    auto step = static_cast<OperationImplied>(operations[stores].opcode);
+    bool x = step == OperationImplied::INX || step == OperationImplied::DEX;
+    bool up = step == OperationImplied::INX || step == OperationImplied::INY;
+    Byte& counter = x ? r_x : r_y;
+
+    // Iterations before the one that brings the counter to zero
+    Byte taken = static_cast<Byte>((up ? -counter : counter) - 1);
+    Uint64 iterations = std::min<Uint64>(
+        taken, (m_deadline - 1 - m_cycles) / block.loopCycles);
+
+    if (iterations == 0)
+    {
+        return;
+    }
+
+    // A watchpoint hit ends the run, and the loop with its iteration
+    Uint64 i = 0;
+
+    while (i < iterations && m_deadline != 0)
+    {
+        for (Uint32 j = 0; j < stores; j++)
         {
-            location = ReadAddress(r_pc);
-            r_pc += 2;
-            Byte index;
+            (this->*operations[j].execute)(operations[j].operand);
+        }
+        counter += up ? 1 : -1;
+        i++;
+    }
+    iterations = i;
+    SetZN(counter);
 
-            if (operation == Operation2::LDX || operation == Operation2::STX)
-            {
-                index = r_y;
-            }
-            else
-            {
-                index = r_x;
-            }
+    m_cycles += iterations * block.loopCycles;
+    m_instructions += iterations * block.count;
+    m_fusedInstructions += iterations * block.count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::RunBlock(const Block& block)
+{
+    const Operation* operation = &m_operations[block.first];
+    const Operation* end = operation + block.count;
+
+    for (; operation != end; operation++)
+    {
+        r_pc += operation->length;
+        (this->*operation->execute)(operation->operand);
+        m_cycles += m_skipCycles + operation->cycles;
+        m_skipCycles = 0;
+        m_instructions++;
 
-            SkipPageCrossCycle(location, location + index);
-            location += index;
+        // Leave to Run what Step would check before the next instruction
+        if (m_cycles >= m_deadline || m_irqCheck || m_pendingNMI)
+        {
             break;
         }
-        default:
-            return (false);
-        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CPU::TranslateBlock(Block& block)
+{
+    std::vector<Operation> operations;
+    std::ptrdiff_t cycles = OffsetOf(&m_cycles);
 
-        Uint16 operand = 0;
+    // Translated code has no dispatch to save, so pairs are split back
+    for (Uint32 i = 0; i < block.count; i++)
+    {
+        const Operation& operation = m_operations[block.first + i];
 
-        switch (operation)
+        if (operation.fused)
         {
-        case Operation2::ASL:
-        case Operation2::ROL:
+            const std::array<Operation, 2>& pair = m_pairs[operation.operand];
+            operations.insert(operations.end(), pair.begin(), pair.end());
+        }
+        else
         {
-            if (mode == AddrMode2::ACCUMULATOR)
-            {
-                bool prev_c = f_c;
-                f_c = r_a & 0x80;
-                r_a <<= 1;
-                r_a = r_a | (prev_c && (operation == Operation2::ROL));
-                SetZN(r_a);
-            }
-            else
-            {
-                bool prev_c = f_c;
-                operand = m_bus.Read(location);
-                f_c = operand & 0x80;
-                operand = operand << 1 | (prev_c &&
-                    (operation == Operation2::ROL));
-                SetZN(operand);
-                m_bus.Write(location, operand);
-            }
-            break;
+            operations.push_back(operation);
         }
-        case Operation2::LSR:
-        case Operation2::ROR:
+    }
+
+    m_dynarec->Begin();
+
+    for (std::size_t i = 0; i < operations.size(); i++)
+    {
+        const Operation& operation = operations[i];
+        bool inlined = false;
+
+        m_dynarec->AddWord(OffsetOf(&r_pc), operation.length);
+
+        if (TranslateInline(operation))
         {
-            if (mode == AddrMode2::ACCUMULATOR)
-            {
-                bool prev_c = f_c;
-                f_c = r_a & 1;
-                r_a >>= 1;
-                r_a = r_a | (prev_c && (operation == Operation2::ROR)) << 7;
-                SetZN(r_a);
-            }
-            else
-            {
-                bool prev_c = f_c;
-                operand = m_bus.Read(location);
-                f_c = operand & 1;
-                operand = operand >> 1 | (prev_c &&
-                    (operation == Operation2::ROR)) << 7;
-                SetZN(operand);
-                m_bus.Write(location, operand);
-            }
-            break;
+            m_dynarec->AddQword(cycles, operation.cycles);
+            inlined = true;
         }
-        case Operation2::STX:
-            m_bus.Write(location, r_x);
-            break;
-        case Operation2::LDX:
-            r_x = m_bus.Read(location);
-            SetZN(r_x);
-            break;
-        case Operation2::DEC:
+        else
         {
-            Byte tmp = m_bus.Read(location) - 1;
-            SetZN(tmp);
-            m_bus.Write(location, tmp);
-            break;
+            m_dynarec->Call(
+                reinterpret_cast<const void*>(
+                    InstructionTable[operation.opcode].invoke),
+                operation.operand
+            );
+            m_dynarec->FlushInt(
+                OffsetOf(&m_skipCycles), cycles, operation.cycles);
         }
-        case Operation2::INC:
+        m_dynarec->AddQword(OffsetOf(&m_instructions), 1);
+
+        bool device =
+            operation.length == 3 && (
+            (operation.operand >= 0x2000 && operation.operand < 0x4020) ||
+            (operation.operand >= 0x8000 && WritesOperand(operation.opcode)));
+
+        if (i + 1 == operations.size() || device)
         {
-            Byte tmp = m_bus.Read(location) + 1;
-            SetZN(tmp);
-            m_bus.Write(location, tmp);
             break;
         }
-        default:
-            return (false);
+
+        m_dynarec->ExitIfAboveEqual(cycles, OffsetOf(&m_deadline));
+
+        // Inline instructions never clear I, move a line nor raise an NMI
+        if (!inlined)
+        {
+            m_dynarec->ExitIfByte(OffsetOf(&m_irqCheck), true);
+            m_dynarec->ExitIfByte(OffsetOf(&m_pendingNMI), true);
         }
+    }
+
+    try
+    {
+        block.code = m_dynarec->End();
+    }
+    catch (const std::runtime_error&)
+    {
+        // Every block translated so far may be lost, so none are used
+        SetBackend(CPUBackend::INTERPRETER);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CPU::TranslateInline(const Operation& operation)
+{
+    using Condition = Dynarec::Condition;
+    Dynarec& dynarec = *m_dynarec;
+    Byte value = static_cast<Byte>(operation.operand);
+    Byte* target = nullptr;
+    const Byte* source = nullptr;
+
+    auto setZN = [&](void)
+    {
+        dynarec.SetCondition(Condition::EQUAL, OffsetOf(&f_z));
+        dynarec.SetCondition(Condition::SIGN, OffsetOf(&f_n));
+    };
+    auto setFlag = [&](const bool* flag, bool state)
+    {
+        dynarec.StoreByte(OffsetOf(flag), state);
+    };
+
+    switch (operation.opcode)
+    {
+    case static_cast<Byte>(OperationImplied::NOP):
+        return (true);
+    case static_cast<Byte>(OperationImplied::CLC):
+        setFlag(&f_c, false);
+        return (true);
+    case static_cast<Byte>(OperationImplied::SEC):
+        setFlag(&f_c, true);
+        return (true);
+    case static_cast<Byte>(OperationImplied::SEI):
+        setFlag(&f_i, true);
+        return (true);
+    case static_cast<Byte>(OperationImplied::CLD):
+        setFlag(&f_d, false);
+        return (true);
+    case static_cast<Byte>(OperationImplied::SED):
+        setFlag(&f_d, true);
+        return (true);
+    case static_cast<Byte>(OperationImplied::CLV):
+        setFlag(&f_v, false);
+        return (true);
+    case static_cast<Byte>(OperationImplied::INX):
+    case static_cast<Byte>(OperationImplied::DEX):
+    case static_cast<Byte>(OperationImplied::INY):
+    case static_cast<Byte>(OperationImplied::DEY):
+    {
+        auto implied = static_cast<OperationImplied>(operation.opcode);
+        bool x = implied == OperationImplied::INX ||
+            implied == OperationImplied::DEX;
+        bool increment = implied == OperationImplied::INX ||
+            implied == OperationImplied::INY;
 
+        dynarec.StepByte(OffsetOf(x ? &r_x : &r_y), increment);
+        setZN();
         return (true);
     }
-    return (false);
+    case static_cast<Byte>(OperationImplied::TAX):
+        source = &r_a; target = &r_x;
+        break;
+    case static_cast<Byte>(OperationImplied::TAY):
+        source = &r_a; target = &r_y;
+        break;
+    case static_cast<Byte>(OperationImplied::TXA):
+        source = &r_x; target = &r_a;
+        break;
+    case static_cast<Byte>(OperationImplied::TYA):
+        source = &r_y; target = &r_a;
+        break;
+    case static_cast<Byte>(OperationImplied::TSX):
+        source = &r_sp; target = &r_x;
+        break;
+    case static_cast<Byte>(OperationImplied::TXS):
+        dynarec.LoadAL(OffsetOf(&r_x));
+        dynarec.StoreAL(OffsetOf(&r_sp));
+        return (true);
+    case 0xA9: // LDA #
+    case 0xA2: // LDX #
+    case 0xA0: // LDY #
+        target = operation.opcode == 0xA9 ? &r_a :
+            operation.opcode == 0xA2 ? &r_x : &r_y;
+        dynarec.StoreByte(OffsetOf(target), value);
+        setFlag(&f_z, value == 0);
+        setFlag(&f_n, value & 0x80);
+        return (true);
+    case 0x09: // ORA #
+    case 0x29: // AND #
+    case 0x49: // EOR #
+        dynarec.LoadAL(OffsetOf(&r_a));
+        dynarec.OperateAL(
+            operation.opcode == 0x09 ? Dynarec::Operation::OR :
+            operation.opcode == 0x29 ? Dynarec::Operation::AND :
+            Dynarec::Operation::XOR,
+            value
+        );
+        dynarec.StoreAL(OffsetOf(&r_a));
+        setZN();
+        return (true);
+    case 0xC9: // CMP #
+    case 0xE0: // CPX #
+    case 0xC0: // CPY #
+        source = operation.opcode == 0xC9 ? &r_a :
+            operation.opcode == 0xE0 ? &r_x : &r_y;
+        dynarec.LoadAL(OffsetOf(source));
+        dynarec.OperateAL(Dynarec::Operation::CMP, value);
+        dynarec.SetCondition(Condition::ABOVE_EQUAL, OffsetOf(&f_c));
+        setZN();
+        return (true);
+    default:
+        return (false);
+    }
+
+    // Register transfers
+    dynarec.LoadAL(OffsetOf(source));
+    dynarec.StoreAL(OffsetOf(target));
+    dynarec.TestAL();
+    setZN();
+    return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::ptrdiff_t CPU::OffsetOf(const void* member) const
+{
+    return (
+        static_cast<const Byte*>(member) - reinterpret_cast<const Byte*>(this)
+    );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -707,6 +1524,19 @@ void CPU::SkipPageCrossCycle(Address a, Address b)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+template <bool PageCross>
+Address CPU::IndexAddress(Address address, Byte index)
+{
+    Address location = address + index;
+
+    if constexpr (PageCross)
+    {
+        SkipPageCrossCycle(address, location);
+    }
+    return (location);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void CPU::SetZN(Byte value)
 {
@@ -715,9 +1545,141 @@ void CPU::SetZN(Byte value)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-bool CPU::IsPendingIRQ(void) const
+bool CPU::IsPendingIRQ(void)
+{
+    if (!m_irqCheck)
+    {
+        return (false);
+    }
+    if (!f_i && m_irqLines != 0)
+    {
+        return (true);
+    }
+
+    // Nothing changes until a line moves or I is cleared again
+    m_irqCheck = false;
+    return (false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <CPU::Handler Execute>
+void CPU::Invoke(CPU& cpu, Address operand)
+{
+    (cpu.*Execute)(operand);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <Byte Load, Byte Store>
+void CPU::ExecutePair(Address operand)
+{
+    constexpr Address storeLength = GetInstructionLength(Store);
+    const std::array<Operation, 2>& pair = m_pairs[operand];
+
+    // An immediate load finds its operand behind the program counter
+    r_pc -= storeLength;
+    (this->*GetHandler<Load>())(pair[0].operand);
+    r_pc += storeLength;
+    (this->*GetHandler<Store>())(pair[1].operand);
+
+    m_instructions++;
+    m_fusedInstructions += 2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <Byte Opcode>
+constexpr CPU::Handler CPU::GetHandler(void)
+{
+    constexpr InstructionType type = GetInstructionType(Opcode);
+    constexpr int operation = (Opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+    constexpr int mode = (Opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+    constexpr bool pageCross = HasPageCrossPenalty(Opcode);
+
+    if constexpr (type == InstructionType::IMPLIED)
+    {
+        return (&CPU::ExecuteImplied<static_cast<OperationImplied>(Opcode)>);
+    }
+    else if constexpr (type == InstructionType::BRANCH)
+    {
+        return (&CPU::ExecuteBranch<
+            static_cast<BranchOnFlag>(Opcode >> BRANCH_ON_FLAG_SHIFT),
+            (Opcode & BRANCH_CONDITION_MASK) != 0
+        >);
+    }
+    else if constexpr (type == InstructionType::TYPE0)
+    {
+        return (&CPU::ExecuteType0<
+            static_cast<Operation0>(operation),
+            static_cast<AddrMode2>(mode),
+            pageCross
+        >);
+    }
+    else if constexpr (type == InstructionType::TYPE1)
+    {
+        return (&CPU::ExecuteType1<
+            static_cast<Operation1>(operation),
+            static_cast<AddrMode1>(mode),
+            pageCross
+        >);
+    }
+    else if constexpr (type == InstructionType::TYPE2)
+    {
+        return (&CPU::ExecuteType2<
+            static_cast<Operation2>(operation),
+            static_cast<AddrMode2>(mode),
+            pageCross
+        >);
+    }
+    else
+    {
+        return (&CPU::ExecuteInvalid);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <Byte Opcode>
+constexpr CPU::Instruction CPU::MakeInstruction(void)
+{
+    constexpr Handler execute = GetHandler<Opcode>();
+    bool invalid = GetInstructionType(Opcode) == InstructionType::INVALID;
+
+    return {
+        execute,
+        &CPU::Invoke<execute>,
+        static_cast<Byte>(GetInstructionLength(Opcode)),
+        static_cast<Byte>(invalid ? 1 : OperationCycles[Opcode]),
+        HasPageCrossPenalty(Opcode)
+    };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t... Opcodes>
+constexpr std::array<CPU::Instruction, 0x100> CPU::MakeInstructionTable(
+    std::index_sequence<Opcodes...>
+)
+{
+    return {{ MakeInstruction<static_cast<Byte>(Opcodes)>()... }};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+constinit const std::array<CPU::Instruction, 0x100> CPU::InstructionTable =
+    CPU::MakeInstructionTable(std::make_index_sequence<0x100>());
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t... Pairs>
+constexpr CPU::PairHandlers CPU::MakePairTable(
+    std::index_sequence<Pairs...>
+)
 {
-    return (!f_i && m_irqPulldowns != 0);
+    return {{
+        &CPU::ExecutePair<
+            FUSED_LOADS[Pairs / FUSED_STORES.size()],
+            FUSED_STORES[Pairs % FUSED_STORES.size()]
+        >...
+    }};
 }
 
+///////////////////////////////////////////////////////////////////////////////
+constinit const CPU::PairHandlers CPU::PairTable =
+    CPU::MakePairTable(std::make_index_sequence<CPU::FUSED_PAIRS>());
+
 } // !namespace NES
@@ -9,8 +9,18 @@
 #include "Core/Processor/MainBus.hpp"
 #include "Core/Processor/IRQHandler.hpp"
 #include "Core/Processor/OpCodes.hpp"
+#include "Core/Processor/Dynarec.hpp"
+#include "Core/Processor/Trace.hpp"
+#include "Core/Processor/Profiler.hpp"
+#include "Core/Shared/CodeDataLogger.hpp"
+#include "Core/Enums.hpp"
 #include "Utils.hpp"
-#include <list>
+#include <deque>
+#include <memory>
+#include <array>
+#include <utility>
+#include <vector>
+#include <functional>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -24,12 +34,129 @@ namespace NES
 ///////////////////////////////////////////////////////////////////////////////
 class CPU
 {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Number of IRQ sources the CPU can be wired to
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr int IRQ_LINES = 8;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Snapshot of the programmer-visible registers
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Registers
+    {
+        Address pc;         //<! Program counter
+        Byte a;             //<! Accumulator
+        Byte x;             //<! X index
+        Byte y;             //<! Y index
+        Byte p;             //<! Status flags, as pushed by PHP without B
+        Byte sp;            //<! Stack pointer
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Member function, and its thunk, executing one opcode given its
+    /// resolved operand address
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using Handler = void (CPU::*)(Address operand);
+    using Invoker = void (*)(CPU& cpu, Address operand);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Entry of the opcode dispatch table
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Instruction
+    {
+        Handler execute;    //<! Handler instantiated for the opcode
+        Invoker invoke;     //<! The same handler, callable without a CPU
+        Byte length;        //<! Instruction length, opcode included
+        Byte cycles;        //<! Base cycle count, one for invalid opcodes
+        bool pageCross;     //<! Extra cycle when indexing crosses a page
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Instruction predecoded from PGR ROM
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Operation
+    {
+        Handler execute;    //<! Handler instantiated for the opcode
+        Address operand;    //<! Operand bytes following the opcode
+        Byte opcode;        //<! Opcode of the instruction
+        Byte length;        //<! Instruction length, opcode included
+        Byte cycles;        //<! Base cycle count
+        bool fused;         //<! LDA/STA pair, the operand indexes m_pairs
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Straight-line run of predecoded instructions
+    ///
+    /// A block ends after the first instruction that can jump, or at the end
+    /// of the 1 KB page it starts in, so a single bank switch can never
+    /// replace part of it.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Block
+    {
+        Uint32 first;       //<! Index of the first operation
+        Uint32 count;       //<! Number of operations
+        Uint32 runs;        //<! Times the block ran while not translated
+        Dynarec::Code code; //<! Translated block, if any
+        Uint32 idleCycles;  //<! Cycles per iteration if an idle loop, or 0
+        Uint32 loopCycles;  //<! Cycles per iteration if a fused loop, or 0
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Runs after which the dynarec translates a block
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr Uint32 HOT_BLOCK_RUNS = 16;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief LDA opcodes that can start a fused copy pair
+    ///
+    /// Immediate, zero page, zero page X, absolute, absolute X and Y.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr std::array<Byte, 6> FUSED_LOADS = {
+        0xA9, 0xA5, 0xB5, 0xAD, 0xBD, 0xB9
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief STA opcodes that can end a fused copy pair
+    ///
+    /// Zero page, zero page X, absolute, absolute X and Y.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr std::array<Byte, 5> FUSED_STORES = {
+        0x85, 0x95, 0x8D, 0x9D, 0x99
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Number of fused copy pair handlers
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr std::size_t FUSED_PAIRS =
+        FUSED_LOADS.size() * FUSED_STORES.size();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Handler of every fused copy pair, load major
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using PairHandlers = std::array<Handler, FUSED_PAIRS>;
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     // Private members
     ///////////////////////////////////////////////////////////////////////////
-    int m_skipCycles;                        //<!
-    int m_cycles;                           //<!
+    static const std::array<Instruction, 0x100> InstructionTable; //<!
+    static const PairHandlers PairTable;    //<!
+    int m_skipCycles;                       //<!
+    Uint64 m_cycles;                        //<!
+    Uint64 m_deadline;                      //<!
     Address r_pc;                           //<!
     Byte r_sp;                              //<!
     Byte r_a;                               //<!
@@ -43,8 +170,26 @@ private:
     bool f_n;                               //<!
     bool m_pendingNMI;                      //<!
     MainBus& m_bus;                         //<!
-    int m_irqPulldowns;                     //<!
-    std::list<IRQHandler> m_irqHandlers;    //<!
+    Byte m_irqLines;                        //<! One bit per asserted line
+    bool m_irqCheck;                        //<! An IRQ may be pending
+    std::array<Uint64, IRQ_LINES> m_irqSchedule; //<! Next assert per line
+    Uint64 m_nextIRQ;                       //<! Earliest of m_irqSchedule
+    std::deque<IRQHandler> m_irqHandlers;   //<!
+    Uint64 m_instructions;                  //<!
+    std::vector<Uint32> m_blockIndex;       //<! Block number + 1 per PGR byte
+    std::vector<Block> m_blocks;            //<! Decoded blocks
+    std::vector<Operation> m_operations;    //<! Operations of every block
+    std::unique_ptr<Dynarec> m_dynarec;     //<! Translator, when enabled
+    Uint32 m_lastBlock;                     //<! Block number + 1 run last
+    Uint64 m_idleCycles;                    //<! Cycles skipped in idle loops
+    std::vector<std::array<Operation, 2>> m_pairs; //<! Fused LDA/STA pairs
+    Uint64 m_fusedInstructions;             //<! Instructions run fused
+    Trace* m_trace;                         //<! Trace to record to, if any
+    CodeDataLogger* m_cdl;                  //<! Logger of executed code
+    Profiler* m_profiler;                   //<! Profiler to sample into
+    Uint64 m_stepPages;                     //<! Pages run only through Step
+    Uint64 m_watchPages;                    //<! Pages with execute watches
+    std::function<bool(Address)> m_watchCallback; //<! Execute watch check
 
 public:
     ///////////////////////////////////////////////////////////////////////////
@@ -57,11 +202,54 @@ public:
 
 public:
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief Step through the CPU's instruction cycle
+    /// \brief Execute the next instruction, or service a pending interrupt
+    ///
+    /// The whole instruction runs at once: its bus accesses all happen at
+    /// the cycle it starts on, then the clock moves past it.
     ///
     ///////////////////////////////////////////////////////////////////////////
     void Step(void);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Execute instructions until the clock reaches a deadline
+    ///
+    /// Returns early after EndRun, or when an IRQ source schedules its line
+    /// before the deadline. Interrupt lines are only looked at after one of
+    /// them changed or the interrupt disable flag was cleared.
+    ///
+    /// Code running from PGR ROM goes through the block cache instead of
+    /// being fetched byte by byte from the bus. Idle loops that can only be
+    /// left through an interrupt are fast-forwarded to the deadline.
+    ///
+    /// \param deadline Cycle at which to stop starting new instructions
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Run(Uint64 deadline);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Make Run return once the current instruction completes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EndRun(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the CPU clock
+    ///
+    /// While an instruction executes this is the cycle it started on.
+    ///
+    /// \return The number of cycles elapsed since construction
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 GetCycles(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if a pending IRQ would be serviced
+    ///
+    /// \return True if the interrupt disable flag is clear
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool IsIRQEnabled(void) const;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Reset the CPU
     ///
@@ -84,6 +272,93 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     Address GetPC(void);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the registers
+    ///
+    /// \return The current register values
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Registers GetRegisters(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the number of instructions executed since construction
+    ///
+    /// \return The number of executed instructions
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 GetInstructionCount(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the number of cycles skipped in idle loops
+    ///
+    /// \return The cycles elided since construction
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 GetIdleCycles(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the number of instructions run as part of a fusion
+    ///
+    /// Counts both LDA/STA copy pairs and the iterations of fused store and
+    /// countdown loops; the ratio to GetInstructionCount is the share of
+    /// the dynamic instruction count the fusions cover.
+    ///
+    /// \return The fused instructions executed since construction
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 GetFusedInstructionCount(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Record every executed instruction into a trace
+    ///
+    /// While a trace is set the block cache, fusions, idle skipping and the
+    /// dynarec are bypassed, so that each instruction is seen by Step. With
+    /// no trace set the only cost is a bit test per block.
+    ///
+    /// \param trace Trace to record to, or nullptr to stop recording
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetTrace(Trace* trace);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Mark executed code and indirect accesses in a Code/Data Logger
+    ///
+    /// Code run from the block cache is marked once, when its block is
+    /// decoded; the cache is flushed so that every block is seen again.
+    ///
+    /// \param cdl Logger to mark PGR ROM bytes in, or nullptr to stop
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetCodeDataLogger(CodeDataLogger* cdl);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Feed calls, returns and samples to a profiler
+    ///
+    /// Samples are taken between blocks, so cycles skipped by idle loops
+    /// and fused loops are charged to the location the CPU leaves them at.
+    ///
+    /// \param profiler Profiler to feed, or nullptr to stop profiling
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetProfiler(Profiler* profiler);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Watch instructions about to run from some 1 KB pages
+    ///
+    /// Code in watched pages runs through Step, which asks the callback
+    /// before each instruction; every other page keeps the block cache and
+    /// the dynarec. When the callback returns true the instruction is left
+    /// unexecuted and Run returns.
+    ///
+    /// \param pages One bit per page, bit n covering addresses n * 1 KB on
+    /// \param callback Function receiving the address of the instruction
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetExecuteWatch(
+        Uint64 pages,
+        std::function<bool(Address)> callback
+    );
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Skip cycles for OAM DMA
     ///
@@ -105,19 +380,62 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Create an IRQHandler
     ///
-    /// \return A reference to the IRQHandler
+    /// \return A reference to the IRQHandler, bound to a line of its own
+    ///
+    /// \throw std::runtime_error if every line is already taken
     ///
     ///////////////////////////////////////////////////////////////////////////
     IRQHandler& CreateIRQHandler(void);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief Set the pulldown state for an IRQ
+    /// \brief Assert or release an interrupt line
+    ///
+    /// \param line Index of the line
+    /// \param state True to assert the line
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetIRQLine(int line, bool state);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Record when an interrupt line may next be asserted
+    ///
+    /// A run in progress stops at that cycle so the caller can bring the
+    /// source up to date.
+    ///
+    /// \param line Index of the line
+    /// \param cycle First cycle that may see the line asserted
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void ScheduleIRQ(int line, Uint64 cycle);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the first cycle any interrupt line may be asserted at
     ///
-    /// \param bit Bit to set the pulldown for
-    /// \param state State to set the pulldown to
+    /// \return The earliest scheduled cycle, or IRQHandler::NEVER
     ///
     ///////////////////////////////////////////////////////////////////////////
-    void SetIRQPulldown(int bit, bool state);
+    Uint64 GetNextIRQ(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Select how the CPU executes code
+    ///
+    /// Both backends produce the same machine state; the interpreter stays
+    /// the reference the dynarec can be checked against.
+    ///
+    /// \param backend Backend to use from the next instruction on
+    ///
+    /// \throw std::runtime_error if the dynarec cannot run on this host
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetBackend(CPUBackend backend);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the backend the CPU executes code with
+    ///
+    /// \return The current backend
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    CPUBackend GetBackend(void) const;
 
 private:
     ///////////////////////////////////////////////////////////////////////////
@@ -129,44 +447,272 @@ private:
     void InterruptSequence(InterruptType type);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief
+    /// \brief Execute an implied instruction
     ///
-    /// \param opcode Opcode to execute
+    /// \param operand Operand bytes following the opcode, if any
     ///
     ///////////////////////////////////////////////////////////////////////////
-    bool ExecuteImplied(Byte opcode);
+    template <OperationImplied Operation>
+    void ExecuteImplied(Address operand);
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Execute a branch instruction
     ///
-    /// \param opcode Opcode to execute
+    /// \param operand Signed branch offset
     ///
     ///////////////////////////////////////////////////////////////////////////
-    bool ExecuteBranch(Byte opcode);
+    template <BranchOnFlag Flag, bool Condition>
+    void ExecuteBranch(Address operand);
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Execute a type 0 instruction
     ///
-    /// \param opcode Opcode to execute
+    /// \param operand Operand bytes following the opcode, if any
     ///
     ///////////////////////////////////////////////////////////////////////////
-    bool ExecuteType0(Byte opcode);
+    template <Operation0 Operation, AddrMode2 Mode, bool PageCross>
+    void ExecuteType0(Address operand);
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Execute a type 1 instruction
     ///
-    /// \param opcode Opcode to execute
+    /// \param operand Operand bytes following the opcode
     ///
     ///////////////////////////////////////////////////////////////////////////
-    bool ExecuteType1(Byte opcode);
+    template <Operation1 Operation, AddrMode1 Mode, bool PageCross>
+    void ExecuteType1(Address operand);
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Execute a type 2 instruction
     ///
-    /// \param opcode Opcode to execute
+    /// \param operand Operand bytes following the opcode, if any
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <Operation2 Operation, AddrMode2 Mode, bool PageCross>
+    void ExecuteType2(Address operand);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Execute an opcode that has no handler, doing nothing
+    ///
+    /// \param operand Unused
     ///
     ///////////////////////////////////////////////////////////////////////////
-    bool ExecuteType2(Byte opcode);
+    void ExecuteInvalid(Address operand);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Find the block starting at an address, decoding it if needed
+    ///
+    /// Blocks are keyed by PGR ROM offset rather than CPU address, so the
+    /// same code mapped through different banks is decoded once, and a bank
+    /// switch only changes which blocks are reached.
+    ///
+    /// \param address Address of the first instruction
+    ///
+    /// \return The block, or nullptr if the address must be interpreted
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Block* FindBlock(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Decode the instructions starting at an address into a block
+    ///
+    /// \param address Address of the first instruction, backed by PGR ROM
+    ///
+    /// \return The block number plus one
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint32 DecodeBlock(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if a block is a loop that waits for an interrupt
+    ///
+    /// The block must branch back to itself and only read memory that does
+    /// not change under it, with instructions that leave the machine in the
+    /// same state on every iteration after the first. The only device read
+    /// allowed is polling the vblank flag, which cannot be set before the
+    /// deadline Run is given.
+    ///
+    /// \param address Address of the first instruction
+    /// \param block Decoded block
+    ///
+    /// \return The cycles one iteration takes, or 0 if it is not idle
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint32 GetIdleLoopCycles(Address address, const Block& block) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if an instruction can be part of an idle loop
+    ///
+    /// \param operation Instruction to check
+    ///
+    /// \return True for register and flag updates that only depend on RAM,
+    /// ROM or constants
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static bool IsIdleOperation(const Operation& operation);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if a block is a counted store or countdown loop
+    ///
+    /// The block must be any number of STA instructions, then INX, DEX, INY
+    /// or DEY, then a BNE back to its start. Stores whose range may reach
+    /// the PPU, APU or mapper registers keep the loop from being fused, so
+    /// it runs one instruction at a time.
+    ///
+    /// \param address Address of the first instruction
+    /// \param block Decoded block
+    ///
+    /// \return The cycles one taken iteration takes, or 0 if not fusable
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint32 GetFusedLoopCycles(Address address, const Block& block) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if an LDA or STA only reaches memory without side effects
+    ///
+    /// Indexed accesses are checked over every address the index can reach.
+    ///
+    /// \param operation Instruction to check
+    ///
+    /// \return True if neither registers nor mapper writes can be reached
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static bool IsPlainMemoryAccess(const Operation& operation);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Fold an STA into the LDA decoded just before it
+    ///
+    /// \param load Decoded LDA, turned into the fused pair on success
+    /// \param store STA following it
+    ///
+    /// \return True if the pair was fused
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool FusePair(Operation& load, const Operation& store);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Run the taken iterations of a fused loop that fit the deadline
+    ///
+    /// The last iteration, and any the deadline cuts short, are left to the
+    /// block itself.
+    ///
+    /// \param block Block with loopCycles set
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void RunFusedLoop(const Block& block);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Execute a block until its end, the deadline, or an interrupt
+    ///
+    /// \param block Block to execute
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void RunBlock(const Block& block);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Translate a block to native code
+    ///
+    /// Instructions are either emitted inline or as a call to their handler,
+    /// followed by the same checks RunBlock makes. Translation also stops
+    /// after an absolute access to the PPU, APU or mapper registers. If the
+    /// host stops letting translated code run, the CPU falls back to the
+    /// interpreter.
+    ///
+    /// \param block Block to translate
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void TranslateBlock(Block& block);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Emit an instruction that only touches registers and flags
+    ///
+    /// \param operation Instruction to emit
+    ///
+    /// \return True if it was emitted, false if it needs its handler
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    bool TranslateInline(const Operation& operation);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the offset of a member from the start of the CPU
+    ///
+    /// \param member Address of the member
+    ///
+    /// \return The offset in bytes, as used by translated code
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::ptrdiff_t OffsetOf(const void* member) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Call a handler on a CPU
+    ///
+    /// \param cpu CPU to run the handler on
+    /// \param operand Operand bytes following the opcode
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <Handler Execute>
+    static void Invoke(CPU& cpu, Address operand);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Execute a fused LDA/STA pair
+    ///
+    /// \param operand Index of the pair in m_pairs
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <Byte Load, Byte Store>
+    void ExecutePair(Address operand);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Select the handler instantiation of an opcode
+    ///
+    /// \return The handler of the opcode
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <Byte Opcode>
+    static constexpr Handler GetHandler(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Build the dispatch table entry of an opcode
+    ///
+    /// \return The handler, length and timing of the opcode
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <Byte Opcode>
+    static constexpr Instruction MakeInstruction(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Build the dispatch table for every opcode
+    ///
+    /// \return The 256-entry dispatch table
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <std::size_t... Opcodes>
+    static constexpr std::array<Instruction, 0x100> MakeInstructionTable(
+        std::index_sequence<Opcodes...>
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Build the handlers of every fused copy pair
+    ///
+    /// \return One handler per FUSED_LOADS and FUSED_STORES combination
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <std::size_t... Pairs>
+    static constexpr PairHandlers MakePairTable(
+        std::index_sequence<Pairs...>
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Add an index to an address, paying the page-cross cycle
+    ///
+    /// \param address Base address
+    /// \param index Index register value
+    ///
+    /// \return The indexed address
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    template <bool PageCross>
+    Address IndexAddress(Address address, Byte index);
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Read an address from the bus
@@ -214,10 +760,13 @@ private:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Check if an IRQ is pending
     ///
+    /// The lines are only looked at when one of them changed or the
+    /// interrupt disable flag was cleared since the last check.
+    ///
     /// \return True if an IRQ is pending, false otherwise
     ///
     ///////////////////////////////////////////////////////////////////////////
-    bool IsPendingIRQ(void) const;
+    bool IsPendingIRQ(void);
 };
 
 } // !namespace NES
@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Processor/Dynarec.hpp"
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+    #define NES_DYNAREC_SUPPORTED
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+Dynarec::Dynarec(std::size_t size)
+    : m_memory(nullptr)
+    , m_size(size)
+    , m_used(0)
+{
+#ifdef NES_DYNAREC_SUPPORTED
+    void* memory = mmap(
+        nullptr, m_size, PROT_READ | PROT_EXEC,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+
+    if (memory == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map dynarec code memory!");
+    }
+    m_memory = static_cast<Byte*>(memory);
+#else
+    throw std::runtime_error("Dynarec is not supported on this host!");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Dynarec::~Dynarec()
+{
+#ifdef NES_DYNAREC_SUPPORTED
+    if (m_memory)
+    {
+        munmap(m_memory, m_size);
+    }
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool Dynarec::IsSupported(void)
+{
+#ifdef NES_DYNAREC_SUPPORTED
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::Begin(void)
+{
+    m_buffer.clear();
+    m_exits.clear();
+
+    Emit({0x53});                   // push rbx
+    Emit({0x48, 0x89, 0xFB});       // mov rbx, rdi
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Dynarec::Code Dynarec::End(void)
+{
+    std::size_t exit = m_buffer.size();
+
+    Emit({0x5B});                   // pop rbx
+    Emit({0xC3});                   // ret
+
+    for (std::size_t jump : m_exits)
+    {
+        Int32 displacement = static_cast<Int32>(exit - (jump + 4));
+        std::memcpy(&m_buffer[jump], &displacement, sizeof(displacement));
+    }
+
+#ifdef NES_DYNAREC_SUPPORTED
+    std::size_t start = (m_used + 15) & ~static_cast<std::size_t>(15);
+
+    if (start + m_buffer.size() > m_size)
+    {
+        return (nullptr);
+    }
+
+    // Only the pages receiving the block are ever writable, and never while
+    // they are executable
+    std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t first = start & ~(pageSize - 1);
+    std::size_t last = start + m_buffer.size();
+
+    // Hosts may refuse the flip, which leaves the block on the interpreter
+    if (mprotect(m_memory + first, last - first, PROT_READ | PROT_WRITE))
+    {
+        return (nullptr);
+    }
+    std::memcpy(m_memory + start, m_buffer.data(), m_buffer.size());
+    if (mprotect(m_memory + first, last - first, PROT_READ | PROT_EXEC))
+    {
+        // The first page also holds blocks published before, which can no
+        // longer run either
+        m_used = m_size;
+        throw std::runtime_error("Failed to make dynarec code executable!");
+    }
+
+    m_used = last;
+    return (reinterpret_cast<Code>(m_memory + start));
+#else
+    return (nullptr);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::Call(const void* function, Uint32 argument)
+{
+    Emit({0x48, 0x89, 0xDF});       // mov rdi, rbx
+    Emit({0xBE});                   // mov esi, imm32
+    EmitValue(argument, 4);
+    Emit({0x48, 0xB8});             // mov rax, imm64
+    EmitValue(reinterpret_cast<Uint64>(function), 8);
+    Emit({0xFF, 0xD0});             // call rax
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::StoreByte(std::ptrdiff_t offset, Byte value)
+{
+    Emit({0xC6});
+    EmitOperand(0, offset);
+    Emit({value});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::AddWord(std::ptrdiff_t offset, Int8 value)
+{
+    Emit({0x66, 0x83});
+    EmitOperand(0, offset);
+    Emit({static_cast<Byte>(value)});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::AddQword(std::ptrdiff_t offset, Int8 value)
+{
+    Emit({0x48, 0x83});
+    EmitOperand(0, offset);
+    Emit({static_cast<Byte>(value)});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::FlushInt(std::ptrdiff_t source, std::ptrdiff_t target, Int8 value)
+{
+    Emit({0x48, 0x63});             // movsxd rax, dword [source]
+    EmitOperand(0, source);
+    Emit({0x48, 0x83, 0xC0});       // add rax, imm8
+    Emit({static_cast<Byte>(value)});
+    Emit({0x48, 0x01});             // add qword [target], rax
+    EmitOperand(0, target);
+    Emit({0xC7});                   // mov dword [source], 0
+    EmitOperand(0, source);
+    EmitValue(0, 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::StepByte(std::ptrdiff_t offset, bool increment)
+{
+    Emit({0xFE});
+    EmitOperand(increment ? 0 : 1, offset);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::LoadAL(std::ptrdiff_t offset)
+{
+    Emit({0x8A});
+    EmitOperand(0, offset);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::StoreAL(std::ptrdiff_t offset)
+{
+    Emit({0x88});
+    EmitOperand(0, offset);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::TestAL(void)
+{
+    Emit({0x84, 0xC0});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::OperateAL(Operation operation, Byte value)
+{
+    Emit({static_cast<Byte>(operation), value});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::SetCondition(Condition condition, std::ptrdiff_t offset)
+{
+    Emit({0x0F, static_cast<Byte>(0x90 | static_cast<Byte>(condition))});
+    EmitOperand(0, offset);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::ExitIfAboveEqual(std::ptrdiff_t a, std::ptrdiff_t b)
+{
+    Emit({0x48, 0x8B});             // mov rax, qword [a]
+    EmitOperand(0, a);
+    Emit({0x48, 0x3B});             // cmp rax, qword [b]
+    EmitOperand(0, b);
+    EmitExit(0x83);                 // jae
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::ExitIfByte(std::ptrdiff_t offset, bool set)
+{
+    Emit({0x80});                   // cmp byte [offset], 0
+    EmitOperand(7, offset);
+    Emit({0x00});
+    EmitExit(set ? 0x85 : 0x84);    // jne or je
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::Emit(std::initializer_list<Byte> bytes)
+{
+    m_buffer.insert(m_buffer.end(), bytes);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::EmitValue(Uint64 value, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        m_buffer.push_back(static_cast<Byte>(value >> (i * 8)));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::EmitOperand(Byte reg, std::ptrdiff_t offset)
+{
+    // mod = 10 (disp32), rm = 011 (rbx)
+    Emit({static_cast<Byte>(0x80 | (reg << 3) | 0x3)});
+    EmitValue(static_cast<Uint64>(offset), 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Dynarec::EmitExit(Byte condition)
+{
+    Emit({0x0F, condition});
+    m_exits.push_back(m_buffer.size());
+    EmitValue(0, 4);
+}
+
+} // !namespace NES
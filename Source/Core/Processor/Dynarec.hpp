@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <vector>
+#include <cstddef>
+#include <initializer_list>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief x86-64 code emitter backed by W^X executable memory
+///
+/// Code is assembled into a private buffer between Begin and End, then
+/// copied into pages that are never writable and executable at the same
+/// time. Translated code receives a context pointer, kept in RBX, and every
+/// memory operand is a byte offset from it.
+///
+///////////////////////////////////////////////////////////////////////////////
+class Dynarec
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Entry point of a translated block
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using Code = void (*)(void* context);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Condition codes usable by SetCondition
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum class Condition : Byte
+    {
+        ABOVE_EQUAL = 0x3,  //<! Carry clear
+        EQUAL = 0x4,        //<! Zero set
+        SIGN = 0x8          //<! Sign set
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief ALU operations on AL with an immediate
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum class Operation : Byte
+    {
+        OR = 0x0C,          //<! OR AL, imm8
+        AND = 0x24,         //<! AND AL, imm8
+        XOR = 0x34,         //<! XOR AL, imm8
+        CMP = 0x3C          //<! CMP AL, imm8
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    Byte* m_memory;                 //<! Executable arena
+    std::size_t m_size;             //<! Size of the arena
+    std::size_t m_used;             //<! Bytes of the arena already used
+    std::vector<Byte> m_buffer;     //<! Block being assembled
+    std::vector<std::size_t> m_exits; //<! Jumps to patch to the block exit
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Map the executable arena
+    ///
+    /// \param size Size of the arena in bytes
+    ///
+    /// \throw std::runtime_error if the host cannot run translated code
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Dynarec(std::size_t size = 0x400000);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Unmap the executable arena
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    ~Dynarec();
+
+    Dynarec(const Dynarec&) = delete;
+    Dynarec& operator=(const Dynarec&) = delete;
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Check if translated code can run on this host
+    ///
+    /// \return True on x86-64 hosts with POSIX memory mapping
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static bool IsSupported(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Start assembling a block
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Begin(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Finish the block and publish it
+    ///
+    /// \return The entry point, or nullptr once the arena is full or if the
+    /// host refuses to make its pages writable
+    ///
+    /// \throw std::runtime_error if the pages cannot be made executable
+    /// again, which also loses the blocks published before
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Code End(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Call function(context, argument)
+    ///
+    /// \param function Address of a function taking the context first
+    /// \param argument 32-bit second argument
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Call(const void* function, Uint32 argument);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief mov byte [context + offset], value
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void StoreByte(std::ptrdiff_t offset, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief add word [context + offset], value
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void AddWord(std::ptrdiff_t offset, Int8 value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief add qword [context + offset], value
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void AddQword(std::ptrdiff_t offset, Int8 value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Add the int at source plus value to the qword at target, then
+    /// clear the int at source
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void FlushInt(std::ptrdiff_t source, std::ptrdiff_t target, Int8 value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief inc or dec byte [context + offset], setting ZF and SF
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void StepByte(std::ptrdiff_t offset, bool increment);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief mov al, byte [context + offset]
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void LoadAL(std::ptrdiff_t offset);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief mov byte [context + offset], al
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void StoreAL(std::ptrdiff_t offset);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief test al, al
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void TestAL(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Apply an ALU operation to AL with an immediate
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void OperateAL(Operation operation, Byte value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief setcc byte [context + offset]
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetCondition(Condition condition, std::ptrdiff_t offset);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Leave the block if qword [context + a] >= qword [context + b]
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void ExitIfAboveEqual(std::ptrdiff_t a, std::ptrdiff_t b);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Leave the block if byte [context + offset] is set or clear
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void ExitIfByte(std::ptrdiff_t offset, bool set);
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Append bytes to the block
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Emit(std::initializer_list<Byte> bytes);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Append a little-endian value to the block
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EmitValue(Uint64 value, int size);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Append a ModRM byte addressing [rbx + disp32] and the offset
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EmitOperand(Byte reg, std::ptrdiff_t offset);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Append a jcc rel32 to the exit, patched by End
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void EmitExit(Byte condition);
+};
+
+} // !namespace NES
@@ -11,20 +11,26 @@ namespace NES
 {
 
 ///////////////////////////////////////////////////////////////////////////////
-IRQHandler::IRQHandler(int bit, CPU& cpu)
-    : bit(bit), cpu(cpu)
+IRQHandler::IRQHandler(int line, CPU& cpu)
+    : line(line), cpu(cpu)
 {}
 
 ///////////////////////////////////////////////////////////////////////////////
 void IRQHandler::Release(void)
 {
-    cpu.SetIRQPulldown(bit, false);
+    cpu.SetIRQLine(line, false);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void IRQHandler::Pull(void)
 {
-    cpu.SetIRQPulldown(bit, true);
+    cpu.SetIRQLine(line, true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void IRQHandler::Schedule(Uint64 cycle)
+{
+    cpu.ScheduleIRQ(line, cycle);
 }
 
 } // !namespace NES
@@ -7,6 +7,7 @@
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
 #include "Utils.hpp"
+#include <limits>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace NES
@@ -20,40 +21,60 @@ namespace NES
 class CPU;
 
 ///////////////////////////////////////////////////////////////////////////////
-/// \brief
+/// \brief One of the CPU interrupt lines, owned by a single IRQ source
 ///
 ///////////////////////////////////////////////////////////////////////////////
 class IRQHandler
 {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Schedule of a line that is not expected to assert
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr Uint64 NEVER = std::numeric_limits<Uint64>::max();
+
 public:
     ///////////////////////////////////////////////////////////////////////////
     // Public members
     ///////////////////////////////////////////////////////////////////////////
-    int bit;
+    int line;
     CPU& cpu;
 
 public:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief
     ///
-    /// \param bit
+    /// \param line Index of the line in the CPU interrupt mask
     /// \param cpu
     ///
     ///////////////////////////////////////////////////////////////////////////
-    IRQHandler(int bit, CPU& cpu);
+    IRQHandler(int line, CPU& cpu);
 
 public:
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief
+    /// \brief Stop asserting the line
     ///
     ///////////////////////////////////////////////////////////////////////////
     void Release(void);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief
+    /// \brief Assert the line
     ///
     ///////////////////////////////////////////////////////////////////////////
     void Pull(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Tell the CPU when the source may next assert the line
+    ///
+    /// The source must have been brought up to date by then, so it can Pull
+    /// before the instruction starting at that cycle. Lines are not expected
+    /// to assert until their source schedules them.
+    ///
+    /// \param cycle First CPU cycle that may see the line asserted, or
+    /// NEVER
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Schedule(Uint64 cycle);
 };
 
 } // !namespace NES
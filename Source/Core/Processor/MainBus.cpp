@@ -25,7 +25,13 @@ MainBus::MainBus(
     , m_apu(apu)
     , m_controller1(controller1)
     , m_controller2(controller2)
-{}
+    , m_cdl(nullptr)
+    , m_watchRead(0)
+    , m_watchWrite(0)
+{
+    m_pages.fill({nullptr, nullptr});
+    MapRAMPages();
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 Address MainBus::NormalizeMirror(Address address)
@@ -40,6 +46,88 @@ Address MainBus::NormalizeMirror(Address address)
 
 ///////////////////////////////////////////////////////////////////////////////
 Byte MainBus::Read(Address address)
+{
+    const Byte* memory = m_pages[address >> 10].read;
+
+    if (memory)
+    {
+        return (memory[address & 0x3FF]);
+    }
+
+    Byte value = ReadHandler(address);
+
+    if (m_watchRead >> (address >> 10) & 1)
+    {
+        m_watchCallback(address, value, false);
+    }
+    return (value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Byte MainBus::Fetch(Address address)
+{
+    const Byte* memory = m_pages[address >> 10].read;
+
+    if (memory)
+    {
+        return (memory[address & 0x3FF]);
+    }
+    if (m_cdl && address >= 0x8000 && m_mapper)
+    {
+        m_cdl->LogPGR(
+            GetPGROffset(address), address, CodeDataLogger::CODE
+        );
+        return (m_mapper->ReadPGR(address));
+    }
+    return (ReadHandler(address));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Byte MainBus::Peek(Address address) const
+{
+    const Byte* memory = m_pages[address >> 10].read;
+
+    if (memory)
+    {
+        return (memory[address & 0x3FF]);
+    }
+    else if (address < 0x2000)
+    {
+        return (m_ram[address & 0x7FF]);
+    }
+    else if (address >= 0x6000 && address < 0x8000)
+    {
+        return (m_extRam[address - 0x6000]);
+    }
+    else if (address >= 0x8000 && m_mapper)
+    {
+        return (m_mapper->ReadPGR(address));
+    }
+    return (0x00);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::Write(Address address, Byte value)
+{
+    Byte* memory = m_pages[address >> 10].write;
+
+    if (memory)
+    {
+        memory[address & 0x3FF] = value;
+    }
+    else
+    {
+        WriteHandler(address, value);
+
+        if (m_watchWrite >> (address >> 10) & 1)
+        {
+            m_watchCallback(address, value, true);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Byte MainBus::ReadHandler(Address address)
 {
     if (address < 0x2000)
     {
@@ -47,6 +135,11 @@ Byte MainBus::Read(Address address)
     }
     else if (address < 0x4020)
     {
+        if (m_syncCallback)
+        {
+            m_syncCallback(address);
+        }
+
         address = NormalizeMirror(address);
         switch (static_cast<Register>(address))
         {
@@ -77,13 +170,19 @@ Byte MainBus::Read(Address address)
     }
     else if (m_mapper)
     {
+        if (m_cdl)
+        {
+            m_cdl->LogPGR(
+                GetPGROffset(address), address, CodeDataLogger::DATA
+            );
+        }
         return (m_mapper->ReadPGR(address));
     }
     return (0x00);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void MainBus::Write(Address address, Byte value)
+void MainBus::WriteHandler(Address address, Byte value)
 {
     if (address < 0x2000)
     {
@@ -91,6 +190,17 @@ void MainBus::Write(Address address, Byte value)
     }
     else if (address < 0x4020)
     {
+        if (m_ppuWriteCallback && address < APU_REGISTER_START)
+        {
+            m_ppuWriteCallback(NormalizeMirror(address), value);
+            return;
+        }
+
+        if (m_syncCallback)
+        {
+            m_syncCallback(address);
+        }
+
         address = NormalizeMirror(address);
 
         switch (static_cast<Register>(address))
@@ -146,7 +256,13 @@ void MainBus::Write(Address address, Byte value)
     }
     else if (m_mapper)
     {
+        if (m_syncCallback)
+        {
+            m_syncCallback(address);
+        }
+
         m_mapper->WritePGR(address, value);
+        MapPGRPages();
     }
 }
 
@@ -158,35 +274,122 @@ bool MainBus::SetMapper(std::shared_ptr<Mapper> mapper)
         return (false);
     }
     m_mapper = mapper;
+    MapPGRPages();
     return (true);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::MapRAMPages(void)
+{
+    for (int page = 0; page < 32; page++)
+    {
+        Byte* ram = nullptr;
+
+        if (page < 8)
+        {
+            // 2 KB of internal RAM mirrored up to $1FFF
+            ram = &m_ram[(page & 1) << 10];
+        }
+        else if (page >= 24)
+        {
+            ram = &m_extRam[(page - 24) << 10];
+        }
+        else
+        {
+            continue;
+        }
+
+        m_pages[page] = {
+            m_watchRead >> page & 1 ? nullptr : ram,
+            m_watchWrite >> page & 1 ? nullptr : ram
+        };
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::MapPGRPages(void)
+{
+    for (int page = 32; page < 64; page++)
+    {
+        bool handled = m_cdl || (m_watchRead >> page & 1);
+
+        m_pages[page].read =
+            handled ? nullptr : m_mapper->GetPGRPointer(page << 10);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 const Byte* MainBus::GetPagePtr(Byte page)
 {
-    Address address = page << 8;
+    const Byte* memory = m_pages[page >> 2].read;
 
-    if (address < 0x2000)
+    if (memory)
     {
-        return (&m_ram[address & 0x7FF]);
+        return (memory + ((page & 0x3) << 8));
     }
-    else if (address < 0x4020)
+    return (nullptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Byte* MainBus::GetPGRPointer(Address address) const
+{
+    if (address < 0x8000 || !m_mapper)
     {
-        // Register address memory pointer access attempt
+        return (nullptr);
     }
-    else if (address < 0x6000)
+    return (m_mapper->GetPGRPointer(address));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Int32 MainBus::GetPGROffset(Address address) const
+{
+    if (address < 0x8000 || !m_mapper)
     {
-        // Expansion ROM access attempted, which is unsupported
+        return (-1);
     }
-    else if (address < 0x8000)
+    return (m_mapper->GetPGROffset(address));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::SetSyncCallback(std::function<void(Address)> callback)
+{
+    m_syncCallback = std::move(callback);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::SetPPUWriteCallback(
+    std::function<void(Address, Byte)> callback
+)
+{
+    m_ppuWriteCallback = std::move(callback);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::SetCodeDataLogger(CodeDataLogger* cdl)
+{
+    m_cdl = cdl;
+    if (m_mapper)
     {
-        return (&m_extRam[address - 0x6000]);
+        MapPGRPages();
     }
-    else
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MainBus::SetWatch(
+    Uint64 read,
+    Uint64 write,
+    std::function<void(Address, Byte, bool)> callback
+)
+{
+    m_watchRead = callback ? read : 0;
+    m_watchWrite = callback ? write : 0;
+    m_watchCallback = std::move(callback);
+
+    MapRAMPages();
+    if (m_mapper)
     {
-        // Unexpected DMA request
+        MapPGRPages();
     }
-    return (nullptr);
 }
 
 } // !namespace NES
@@ -7,10 +7,12 @@
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
 #include "Core/Shared/Bus.hpp"
+#include "Core/Shared/CodeDataLogger.hpp"
 #include "Core/Picture/PPU.hpp"
 #include "Core/Audio/APU.hpp"
 #include "Core/Controller.hpp"
 #include <vector>
+#include <array>
 #include <functional>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -52,17 +54,38 @@ public:
         JOY2_AND_FRAME_CONTROL = 0x4017
     };
 
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Descriptor of a 1 KB page of the CPU address space
+    ///
+    /// Pages without host memory behind them go through the register and
+    /// mapper handlers instead.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Page
+    {
+        const Byte* read;   //<! Memory reads come from, or nullptr
+        Byte* write;        //<! Memory writes go to, or nullptr
+    };
+
 private:
     ///////////////////////////////////////////////////////////////////////////
     // Private members
     ///////////////////////////////////////////////////////////////////////////
+    std::array<Page, 64> m_pages;               //<! CPU address space map
     std::vector<Byte> m_ram;                    //<! Internal RAM
     std::vector<Byte> m_extRam;                 //<! External RAM
     std::function<void(Byte)> m_dmaCallback;    //<! DMA callback function
+    std::function<void(Address)> m_syncCallback;//<! Device sync callback
+    std::function<void(Address, Byte)> m_ppuWriteCallback; //<! PPU writes
     PPU& m_ppu;                                 //<! Reference to the PPU
     APU& m_apu;                                 //<! Reference to the APU
     Controller& m_controller1;                  //<! First controller
     Controller& m_controller2;                  //<! Second controller
+    CodeDataLogger* m_cdl;                      //<! Logger of PGR use, if any
+    Uint64 m_watchRead;                         //<! Pages with read watches
+    Uint64 m_watchWrite;                        //<! Pages with write watches
+    std::function<void(Address, Byte, bool)> m_watchCallback; //<! Watcher
 
 public:
     ///////////////////////////////////////////////////////////////////////////
@@ -94,6 +117,31 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     virtual Byte Read(Address address) override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Read a byte of the instruction stream
+    ///
+    /// Same as Read, but logged as code rather than data.
+    ///
+    /// \param address Address to read from
+    ///
+    /// \return The byte read from the bus
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Byte Fetch(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Read a byte without side effects
+    ///
+    /// Registers read as zero, memory and PGR ROM as they are. Neither
+    /// logged nor watched, for debuggers to look at the machine with.
+    ///
+    /// \param address Address to read from
+    ///
+    /// \return The byte at the address
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Byte Peek(Address address) const;
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Write a byte to the bus
     ///
@@ -114,16 +162,123 @@ public:
     virtual bool SetMapper(std::shared_ptr<Mapper> mapper) override;
 
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief Get the pointer to a specific page in the RAM
+    /// \brief Get the host memory behind a 256-byte page
     ///
     /// \param page Page number to get the pointer for
     ///
-    /// \return Pointer to the start of the specified page in RAM
+    /// \return Pointer to the start of the page, or nullptr if the page is
+    /// made of registers
     ///
     ///////////////////////////////////////////////////////////////////////////
     const Byte* GetPagePtr(Byte page);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the PGR ROM byte mapped at an address
+    ///
+    /// \param address Address to look up
+    ///
+    /// \return Pointer to the byte, or nullptr if the address is not backed
+    /// by PGR ROM the mapper publishes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    const Byte* GetPGRPointer(Address address) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the PGR ROM offset mapped at an address
+    ///
+    /// \param address Address to look up
+    ///
+    /// \return Offset into PGR ROM, or -1 if the address is not backed by
+    /// PGR ROM the mapper publishes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Int32 GetPGROffset(Address address) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Set the callback run before an access reaches a device
+    ///
+    /// It is called for every register access in $2000-$401F and for every
+    /// write to the mapper, so the devices can be caught up to the CPU.
+    ///
+    /// \param callback Function receiving the accessed address
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetSyncCallback(std::function<void(Address)> callback);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Hand the PPU register writes to a callback
+    ///
+    /// While set, writes to $2000-$3FFF no longer reach the PPU nor the
+    /// sync callback, for a PPU run elsewhere that applies them itself.
+    ///
+    /// \param callback Function receiving the register, $2000-$2007, and
+    /// the value written, or an empty function to write the PPU again
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetPPUWriteCallback(std::function<void(Address, Byte)> callback);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Log the PGR ROM reads into a Code/Data Logger
+    ///
+    /// While logging, PGR pages are left out of the page table so that
+    /// every read reaches the handler that marks it.
+    ///
+    /// \param cdl Logger to mark PGR ROM bytes in, or nullptr to stop
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetCodeDataLogger(CodeDataLogger* cdl);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Watch the reads and writes of some 1 KB pages
+    ///
+    /// Watched pages are left out of the page table, so that their accesses
+    /// reach the handlers, which report them once made. Accesses to other
+    /// pages cost nothing more. Instruction fetches are not reported.
+    ///
+    /// \param read Pages whose reads are reported, bit n for n * 1 KB on
+    /// \param write Pages whose writes are reported
+    /// \param callback Function receiving the address, the byte read or
+    /// written, and true for a write
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void SetWatch(
+        Uint64 read,
+        Uint64 write,
+        std::function<void(Address, Byte, bool)> callback
+    );
+
 private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Put internal and external RAM into the page table
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void MapRAMPages(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Copy the PGR banks the mapper publishes into the page table
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void MapPGRPages(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Read a byte through the register and mapper handlers
+    ///
+    /// \param address Address to read from
+    ///
+    /// \return The byte read
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Byte ReadHandler(Address address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write a byte through the register and mapper handlers
+    ///
+    /// \param address Address to write to
+    /// \param value Value to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void WriteHandler(Address address, Byte value);
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Normalize a mirror address
     ///
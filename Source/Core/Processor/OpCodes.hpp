@@ -193,4 +193,280 @@ static constexpr int OperationCycles[0x100] =
     2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0
 };
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Decoder family an opcode belongs to
+///
+///////////////////////////////////////////////////////////////////////////////
+enum class InstructionType
+{
+    INVALID,
+    IMPLIED,
+    BRANCH,
+    TYPE0,
+    TYPE1,
+    TYPE2
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Check if an opcode is one of the implied operations
+///
+/// \param opcode Opcode to check
+///
+/// \return True if the opcode is listed in OperationImplied
+///
+///////////////////////////////////////////////////////////////////////////////
+constexpr bool IsImpliedOperation(Byte opcode)
+{
+    switch (static_cast<OperationImplied>(opcode))
+    {
+    case OperationImplied::NOP:
+    case OperationImplied::BRK:
+    case OperationImplied::JSR:
+    case OperationImplied::RTI:
+    case OperationImplied::RTS:
+    case OperationImplied::JMP:
+    case OperationImplied::JMPI:
+    case OperationImplied::PHP:
+    case OperationImplied::PLP:
+    case OperationImplied::PHA:
+    case OperationImplied::PLA:
+    case OperationImplied::DEY:
+    case OperationImplied::DEX:
+    case OperationImplied::TAY:
+    case OperationImplied::INY:
+    case OperationImplied::INX:
+    case OperationImplied::CLC:
+    case OperationImplied::SEC:
+    case OperationImplied::CLI:
+    case OperationImplied::SEI:
+    case OperationImplied::TYA:
+    case OperationImplied::CLV:
+    case OperationImplied::CLD:
+    case OperationImplied::SED:
+    case OperationImplied::TXA:
+    case OperationImplied::TXS:
+    case OperationImplied::TAX:
+    case OperationImplied::TSX:
+        return (true);
+    default:
+        return (false);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Decode the family of an opcode from its bit fields
+///
+/// Opcodes without a cycle count, or whose operation/addressing mode pair
+/// has no meaning in their family, are reported as INVALID.
+///
+/// \param opcode Opcode to decode
+///
+/// \return The family of the opcode
+///
+///////////////////////////////////////////////////////////////////////////////
+constexpr InstructionType GetInstructionType(Byte opcode)
+{
+    int operation = (opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+    AddrMode2 mode = static_cast<AddrMode2>(
+        (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT);
+    bool validMode =
+        mode == AddrMode2::IMMEDIATE ||
+        mode == AddrMode2::ZERO_PAGE ||
+        mode == AddrMode2::ACCUMULATOR ||
+        mode == AddrMode2::ABSOLUTE ||
+        mode == AddrMode2::INDEXED ||
+        mode == AddrMode2::ABSOLUTE_INDEXED;
+
+    if (OperationCycles[opcode] == 0)
+    {
+        return (InstructionType::INVALID);
+    }
+    else if (IsImpliedOperation(opcode))
+    {
+        return (InstructionType::IMPLIED);
+    }
+    else if (
+        (opcode & BRANCH_INSTRUCTION_MASK) == BRANCH_INSTRUCTION_MASK_RESULT
+    )
+    {
+        return (InstructionType::BRANCH);
+    }
+
+    switch (opcode & INSTRUCTION_MODE_MASK)
+    {
+    case 0x1:
+        return (InstructionType::TYPE1);
+    case 0x2:
+        return (validMode ? InstructionType::TYPE2 : InstructionType::INVALID);
+    case 0x0:
+        if (!validMode || mode == AddrMode2::ACCUMULATOR ||
+            (operation != static_cast<int>(Operation0::BIT) &&
+            operation < static_cast<int>(Operation0::STY)))
+        {
+            return (InstructionType::INVALID);
+        }
+        return (InstructionType::TYPE0);
+    default:
+        return (InstructionType::INVALID);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Get the length of an instruction, opcode byte included
+///
+/// \param opcode Opcode of the instruction
+///
+/// \return The number of bytes the instruction occupies
+///
+///////////////////////////////////////////////////////////////////////////////
+constexpr int GetInstructionLength(Byte opcode)
+{
+    int mode = (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+
+    switch (GetInstructionType(opcode))
+    {
+    case InstructionType::IMPLIED:
+        switch (static_cast<OperationImplied>(opcode))
+        {
+        case OperationImplied::JSR:
+        case OperationImplied::JMP:
+        case OperationImplied::JMPI:
+            return (3);
+        default:
+            return (1);
+        }
+    case InstructionType::BRANCH:
+        return (2);
+    case InstructionType::TYPE1:
+        switch (static_cast<AddrMode1>(mode))
+        {
+        case AddrMode1::ABSOLUTE:
+        case AddrMode1::ABSOLUTE_Y:
+        case AddrMode1::ABSOLUTE_X:
+            return (3);
+        default:
+            return (2);
+        }
+    case InstructionType::TYPE0:
+    case InstructionType::TYPE2:
+        switch (static_cast<AddrMode2>(mode))
+        {
+        case AddrMode2::ACCUMULATOR:
+            return (1);
+        case AddrMode2::ABSOLUTE:
+        case AddrMode2::ABSOLUTE_INDEXED:
+            return (3);
+        default:
+            return (2);
+        }
+    default:
+        return (1);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Check if an instruction takes an extra cycle when its indexed
+/// effective address crosses a page
+///
+/// Only reads pay the penalty: stores and read-modify-write instructions
+/// always spend the fix-up cycle, which OperationCycles already counts.
+/// Taken branches are timed by the branch handler itself.
+///
+/// \param opcode Opcode of the instruction
+///
+/// \return True if a page crossing adds a cycle
+///
+///////////////////////////////////////////////////////////////////////////////
+constexpr bool HasPageCrossPenalty(Byte opcode)
+{
+    int operation = (opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+    int mode = (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+
+    switch (GetInstructionType(opcode))
+    {
+    case InstructionType::TYPE1:
+        return (
+            static_cast<Operation1>(operation) != Operation1::STA && (
+            static_cast<AddrMode1>(mode) == AddrMode1::INDIRECT_Y ||
+            static_cast<AddrMode1>(mode) == AddrMode1::ABSOLUTE_Y ||
+            static_cast<AddrMode1>(mode) == AddrMode1::ABSOLUTE_X)
+        );
+    case InstructionType::TYPE2:
+        return (
+            static_cast<Operation2>(operation) == Operation2::LDX &&
+            static_cast<AddrMode2>(mode) == AddrMode2::ABSOLUTE_INDEXED
+        );
+    case InstructionType::TYPE0:
+        return (
+            static_cast<Operation0>(operation) != Operation0::STY &&
+            static_cast<AddrMode2>(mode) == AddrMode2::ABSOLUTE_INDEXED
+        );
+    default:
+        return (false);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Check if an instruction may move the program counter elsewhere
+/// than the next instruction
+///
+/// \param opcode Opcode of the instruction
+///
+/// \return True for branches, jumps, calls, returns and BRK
+///
+///////////////////////////////////////////////////////////////////////////////
+constexpr bool EndsBasicBlock(Byte opcode)
+{
+    switch (GetInstructionType(opcode))
+    {
+    case InstructionType::BRANCH:
+        return (true);
+    case InstructionType::IMPLIED:
+        switch (static_cast<OperationImplied>(opcode))
+        {
+        case OperationImplied::BRK:
+        case OperationImplied::JSR:
+        case OperationImplied::RTI:
+        case OperationImplied::RTS:
+        case OperationImplied::JMP:
+        case OperationImplied::JMPI:
+            return (true);
+        default:
+            return (false);
+        }
+    default:
+        return (false);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Check if an instruction writes to the location it addresses
+///
+/// \param opcode Opcode of the instruction
+///
+/// \return True for stores and read-modify-write instructions
+///
+///////////////////////////////////////////////////////////////////////////////
+constexpr bool WritesOperand(Byte opcode)
+{
+    int operation = (opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+    int mode = (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+
+    switch (GetInstructionType(opcode))
+    {
+    case InstructionType::TYPE0:
+        return (static_cast<Operation0>(operation) == Operation0::STY);
+    case InstructionType::TYPE1:
+        return (static_cast<Operation1>(operation) == Operation1::STA);
+    case InstructionType::TYPE2:
+        return (
+            static_cast<Operation2>(operation) != Operation2::LDX &&
+            static_cast<AddrMode2>(mode) != AddrMode2::ACCUMULATOR &&
+            static_cast<AddrMode2>(mode) != AddrMode2::IMMEDIATE
+        );
+    default:
+        return (false);
+    }
+}
+
 } // !namespace NES
@@ -0,0 +1,305 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Processor/Profiler.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+static bool ParseNumber(const std::string& text, int base, Uint64& value)
+{
+    // Unlike strtoull alone, no sign, space or trailing text is let through
+    if (text.empty() || !std::isxdigit(static_cast<unsigned char>(text[0])))
+    {
+        return (false);
+    }
+
+    char* end = nullptr;
+
+    errno = 0;
+    value = std::strtoull(text.c_str(), &end, base);
+    return (errno == 0 && end == text.c_str() + text.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Profiler::Profiler(Uint64 interval, Uint64 start)
+    : m_interval(interval)
+    , m_nextSample(start + interval)
+{
+    if (interval == 0)
+    {
+        throw std::runtime_error("Profiler interval must not be zero!");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::Call(Address address, Int32 offset, Byte sp)
+{
+    Return(sp);
+
+    // Code that never returns would grow the stack forever
+    if (m_stack.size() < MAX_DEPTH)
+    {
+        m_stack.push_back({GetLocation(address, offset), sp});
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::Return(Byte sp)
+{
+    while (!m_stack.empty() && m_stack.back().sp < sp)
+    {
+        m_stack.pop_back();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::Sample(Address address, Int32 offset, Byte sp, Uint64 cycles)
+{
+    if (cycles < m_nextSample)
+    {
+        return;
+    }
+
+    // Idle loops and fused loops run many intervals at once
+    Uint64 weight = (cycles - m_nextSample) / m_interval + 1;
+    std::vector<Uint32> key;
+
+    m_nextSample += weight * m_interval;
+
+    Return(sp);
+    key.reserve(m_stack.size() + 1);
+    for (const Frame& frame : m_stack)
+    {
+        key.push_back(frame.location);
+    }
+    key.push_back(GetLocation(address, offset));
+
+    m_samples[key] += weight;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::Clear(void)
+{
+    m_samples.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t Profiler::LoadSymbols(const Path& path)
+{
+    std::ifstream file(path);
+    std::size_t count = 0;
+    std::string line;
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error(
+            "Failed to open symbol file: " + path.string()
+        );
+    }
+
+    if (path.extension() == ".nl")
+    {
+        // rom.nes.ram.nl or rom.nes.<bank>.nl
+        std::string suffix = path.stem().extension().string();
+        Uint64 bank = 0;
+        bool ram = suffix.size() < 2 ||
+            !ParseNumber(suffix.substr(1), 16, bank) || bank > 0xFF;
+        Uint32 base = ram ? 0 : static_cast<Uint32>(bank << 14);
+
+        while (std::getline(file, line))
+        {
+            // $C000#Name#Comment
+            std::size_t name = line.find('#');
+            std::size_t end = line.find('#', name + 1);
+            Uint64 value = 0;
+
+            if (line.empty() || line[0] != '$' || name == std::string::npos ||
+                !ParseNumber(line.substr(1, name - 1), 16, value) ||
+                value > 0xFFFF)
+            {
+                continue;
+            }
+
+            Address address = static_cast<Address>(value);
+            Uint32 location = ram || address < 0x8000
+                ? address | RAM_LOCATION : base | (address & 0x3FFF);
+
+            m_symbols[location] = line.substr(name + 1, end - name - 1);
+            count++;
+        }
+        return (count);
+    }
+
+    // ca65 debug information, one record per line: "type key=value,..."
+    struct Segment
+    {
+        Uint32 start;
+        Uint32 size;
+        Int64 offset;
+    };
+    std::map<Uint32, Segment> segments;
+    std::vector<std::map<std::string, std::string>> symbols;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream record(line);
+        std::string type;
+        std::string field;
+        std::map<std::string, std::string> fields;
+
+        std::getline(record, type, '\t');
+        while (std::getline(record, field, ','))
+        {
+            std::size_t equal = field.find('=');
+
+            if (equal != std::string::npos)
+            {
+                std::string value = field.substr(equal + 1);
+
+                if (!value.empty() && value.front() == '"')
+                {
+                    value = value.substr(1, value.size() - 2);
+                }
+                fields[field.substr(0, equal)] = value;
+            }
+        }
+
+        Uint64 id = 0;
+        Uint64 start = 0;
+        Uint64 size = 0;
+        Uint64 offset = 0;
+
+        // Records that do not parse are left out, symbols being optional
+        if (type == "seg" && ParseNumber(fields["id"], 10, id) &&
+            ParseNumber(fields["start"], 0, start) &&
+            ParseNumber(fields["size"], 0, size))
+        {
+            bool written = fields.count("ooffs") &&
+                ParseNumber(fields["ooffs"], 0, offset);
+
+            segments[static_cast<Uint32>(id)] = {
+                static_cast<Uint32>(start),
+                static_cast<Uint32>(size),
+                written ? static_cast<Int64>(offset) - 16 : -1
+            };
+        }
+        else if (type == "sym" && fields["type"] == "lab" &&
+            fields.count("val"))
+        {
+            symbols.push_back(fields);
+        }
+    }
+
+    for (auto& fields : symbols)
+    {
+        Uint64 number = 0;
+        Uint64 id = 0;
+
+        if (!ParseNumber(fields["val"], 0, number))
+        {
+            continue;
+        }
+
+        Uint32 value = static_cast<Uint32>(number);
+        auto segment = ParseNumber(fields["seg"], 10, id)
+            ? segments.find(static_cast<Uint32>(id)) : segments.end();
+        Uint32 location = (value & 0xFFFF) | RAM_LOCATION;
+
+        if (segment != segments.end() && segment->second.offset >= 0 &&
+            value >= segment->second.start &&
+            value < segment->second.start + segment->second.size)
+        {
+            location = static_cast<Uint32>(
+                segment->second.offset + value - segment->second.start);
+        }
+
+        m_symbols[location] = fields["name"];
+        count++;
+    }
+    return (count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::WriteCollapsed(std::ostream& out) const
+{
+    // Locations sharing a symbol collapse into the same frame
+    std::map<std::string, Uint64> stacks;
+
+    for (const auto& [key, count] : m_samples)
+    {
+        std::string stack;
+
+        for (Uint32 location : key)
+        {
+            if (!stack.empty())
+            {
+                stack += ';';
+            }
+            stack += GetName(location);
+        }
+        stacks[stack] += count;
+    }
+
+    for (const auto& [stack, count] : stacks)
+    {
+        out << stack << ' ' << count << '\n';
+    }
+    out.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint32 Profiler::GetLocation(Address address, Int32 offset)
+{
+    if (offset < 0)
+    {
+        return (address | RAM_LOCATION);
+    }
+    return (static_cast<Uint32>(offset));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::string Profiler::GetName(Uint32 location) const
+{
+    auto symbol = m_symbols.upper_bound(location);
+    char name[16];
+
+    if (symbol != m_symbols.begin())
+    {
+        --symbol;
+
+        // Only symbols of the same bank, or of the address space, apply
+        Uint32 region = location & RAM_LOCATION ? RAM_LOCATION : ~0x3FFFu;
+
+        if ((symbol->first & region) == (location & region))
+        {
+            return (symbol->second);
+        }
+    }
+
+    if (location & RAM_LOCATION)
+    {
+        std::snprintf(name, sizeof(name), "$%04X", location & 0xFFFF);
+    }
+    else
+    {
+        // Bank and offset within it, as in FCEUX name list files
+        std::snprintf(name, sizeof(name), "%02X:%04X",
+            location >> 14, location & 0x3FFF);
+    }
+    return (name);
+}
+
+} // !namespace NES
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <vector>
+#include <map>
+#include <string>
+#include <ostream>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Sampling profiler of the guest program
+///
+/// Every few CPU cycles the current PC and the routines it was called from
+/// are sampled. Calls are followed through a shadow stack fed by JSR, RTS,
+/// interrupts and RTI. Samples are reported as collapsed stacks, the input
+/// of flame graph tools, with the routines named from symbol files.
+///
+/// Code locations are keyed by PGR ROM offset, so the same routine reached
+/// through different banks stays one frame, and routines of different
+/// banks sharing an address stay apart.
+///
+///////////////////////////////////////////////////////////////////////////////
+class Profiler
+{
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Routine entered by a call or an interrupt
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        Uint32 location;    //<! Key of the routine entry point
+        Byte sp;            //<! Stack pointer once the return was pushed
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private constants
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr Uint32 RAM_LOCATION = 0x80000000; //<! Flag of addresses
+    static constexpr std::size_t MAX_DEPTH = 64;       //<! Deepest stack kept
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 m_interval;                  //<! Cycles between two samples
+    Uint64 m_nextSample;                //<! Cycle of the next sample
+    std::vector<Frame> m_stack;         //<! Shadow call stack
+    std::map<std::vector<Uint32>, Uint64> m_samples; //<! Count per stack
+    std::map<Uint32, std::string> m_symbols;        //<! Name per location
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create a profiler with no samples
+    ///
+    /// \param interval Number of CPU cycles between two samples
+    /// \param start CPU cycle count at which sampling starts
+    ///
+    /// \throw std::runtime_error if the interval is zero
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Profiler(Uint64 interval, Uint64 start);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the cycle at which the next sample is due
+    ///
+    /// \return The cycle count
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Uint64 GetNextSample(void) const
+    {
+        return (m_nextSample);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Enter a routine
+    ///
+    /// \param address CPU address of the routine
+    /// \param offset PGR ROM offset of the routine, or -1 outside ROM
+    /// \param sp Stack pointer after the return address was pushed
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Call(Address address, Int32 offset, Byte sp);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Leave the routines whose return address got pulled
+    ///
+    /// Any way of dropping the return address counts, so code that pulls
+    /// it by hand or resets the stack does not leave stale frames behind.
+    ///
+    /// \param sp Current stack pointer
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Return(Byte sp);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Record the current location, weighted by the samples due
+    ///
+    /// \param address CPU address of the next instruction
+    /// \param offset PGR ROM offset of the next instruction, or -1
+    /// \param sp Current stack pointer
+    /// \param cycles Current CPU cycle count
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Sample(Address address, Int32 offset, Byte sp, Uint64 cycles);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Forget every sample, keeping the call stack and symbols
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Clear(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Load names from a symbol file
+    ///
+    /// FCEUX name lists are recognised by their .nl extension: "rom.ram.nl"
+    /// files name addresses, "rom.N.nl" files name the 16 KB PGR bank N. Any
+    /// other file is read as ca65 debug information, where symbols of
+    /// segments written to the ROM are placed through their file offset,
+    /// the 16-byte iNES header being skipped.
+    ///
+    /// \param path Path of the symbol file
+    ///
+    /// \return The number of symbols loaded
+    ///
+    /// \throw std::runtime_error if the file cannot be opened
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t LoadSymbols(const Path& path);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write the samples as collapsed stacks
+    ///
+    /// Each line lists the frames from the outermost routine to the sampled
+    /// location, separated by semicolons, then the number of samples.
+    ///
+    /// \param out Stream to write to
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void WriteCollapsed(std::ostream& out) const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the key of a code location
+    ///
+    /// \param address CPU address
+    /// \param offset PGR ROM offset, or -1 outside ROM
+    ///
+    /// \return The offset if in ROM, the flagged address otherwise
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static Uint32 GetLocation(Address address, Int32 offset);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Name a location after the closest symbol at or before it
+    ///
+    /// ROM symbols only name locations of their own 16 KB bank.
+    ///
+    /// \param location Key of the location
+    ///
+    /// \return The symbol, or the location in hexadecimal
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::string GetName(Uint32 location) const;
+};
+
+} // !namespace NES
@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Processor/Trace.hpp"
+#include "Core/Processor/OpCodes.hpp"
+#include <stdexcept>
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+Trace::Trace(std::size_t capacity, PositionCallback position)
+    : m_entries(capacity)
+    , m_mask(capacity - 1)
+    , m_count(0)
+    , m_position(position)
+{
+    if (capacity == 0 || (capacity & m_mask) != 0)
+    {
+        throw std::runtime_error("Trace capacity must be a power of two!");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Trace::Record(const Entry& entry)
+{
+    Entry& slot = m_entries[m_count & m_mask];
+
+    slot = entry;
+    if (m_position)
+    {
+        m_position(slot);
+    }
+    m_count++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Trace::Clear(void)
+{
+    m_count = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t Trace::GetSize(void) const
+{
+    return (m_count < m_entries.size() ? m_count : m_entries.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Trace::Dump(std::ostream& out) const
+{
+    for (Uint64 i = m_count - GetSize(); i < m_count; i++)
+    {
+        out << Format(m_entries[i & m_mask]) << '\n';
+    }
+    out.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::string Trace::Format(const Entry& entry)
+{
+    int length = GetInstructionType(entry.opcode) == InstructionType::INVALID
+        ? 1 : GetInstructionLength(entry.opcode);
+    char bytes[16];
+    char line[128];
+
+    switch (length)
+    {
+    case 3:
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X %02X",
+            entry.opcode, entry.operands[0], entry.operands[1]);
+        break;
+    case 2:
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X",
+            entry.opcode, entry.operands[0]);
+        break;
+    default:
+        std::snprintf(bytes, sizeof(bytes), "%02X", entry.opcode);
+        break;
+    }
+
+    std::snprintf(line, sizeof(line),
+        "%04X  %-9s %-32sA:%02X X:%02X Y:%02X P:%02X SP:%02X "
+        "PPU:%3d,%3d CYC:%llu",
+        entry.pc, bytes, Disassemble(entry).c_str(),
+        entry.a, entry.x, entry.y, entry.p, entry.sp,
+        entry.scanline, entry.dot,
+        static_cast<unsigned long long>(entry.cycle)
+    );
+    return (line);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::string Trace::Disassemble(const Entry& entry)
+{
+    static const char* const type0[8] = {
+        "???", "BIT", "???", "???", "STY", "LDY", "CPY", "CPX"
+    };
+    static const char* const type1[8] = {
+        "ORA", "AND", "EOR", "ADC", "STA", "LDA", "CMP", "SBC"
+    };
+    static const char* const type2[8] = {
+        "ASL", "ROL", "LSR", "ROR", "STX", "LDX", "DEC", "INC"
+    };
+    static const char* const branches[4][2] = {
+        {"BPL", "BMI"}, {"BVC", "BVS"}, {"BCC", "BCS"}, {"BNE", "BEQ"}
+    };
+
+    Byte opcode = entry.opcode;
+    int operation = (opcode & OPERATION_MASK) >> OPERATION_SHIFT;
+    int mode = (opcode & ADDR_MODE_MASK) >> ADDR_MODE_SHIFT;
+    Address absolute = static_cast<Address>(
+        entry.operands[1] << 8 | entry.operands[0]);
+    Byte zero = entry.operands[0];
+    const char* name = "???";
+    char text[32];
+
+    switch (GetInstructionType(opcode))
+    {
+    case InstructionType::IMPLIED:
+        switch (static_cast<OperationImplied>(opcode))
+        {
+        case OperationImplied::JSR:
+            std::snprintf(text, sizeof(text), "JSR $%04X", absolute);
+            return (text);
+        case OperationImplied::JMP:
+            std::snprintf(text, sizeof(text), "JMP $%04X", absolute);
+            return (text);
+        case OperationImplied::JMPI:
+            std::snprintf(text, sizeof(text), "JMP ($%04X)", absolute);
+            return (text);
+        case OperationImplied::NOP: return ("NOP");
+        case OperationImplied::BRK: return ("BRK");
+        case OperationImplied::RTI: return ("RTI");
+        case OperationImplied::RTS: return ("RTS");
+        case OperationImplied::PHP: return ("PHP");
+        case OperationImplied::PLP: return ("PLP");
+        case OperationImplied::PHA: return ("PHA");
+        case OperationImplied::PLA: return ("PLA");
+        case OperationImplied::DEY: return ("DEY");
+        case OperationImplied::DEX: return ("DEX");
+        case OperationImplied::TAY: return ("TAY");
+        case OperationImplied::INY: return ("INY");
+        case OperationImplied::INX: return ("INX");
+        case OperationImplied::CLC: return ("CLC");
+        case OperationImplied::SEC: return ("SEC");
+        case OperationImplied::CLI: return ("CLI");
+        case OperationImplied::SEI: return ("SEI");
+        case OperationImplied::TYA: return ("TYA");
+        case OperationImplied::CLV: return ("CLV");
+        case OperationImplied::CLD: return ("CLD");
+        case OperationImplied::SED: return ("SED");
+        case OperationImplied::TXA: return ("TXA");
+        case OperationImplied::TXS: return ("TXS");
+        case OperationImplied::TAX: return ("TAX");
+        case OperationImplied::TSX: return ("TSX");
+        }
+        return ("???");
+    case InstructionType::BRANCH:
+        std::snprintf(text, sizeof(text), "%s $%04X",
+            branches[opcode >> BRANCH_ON_FLAG_SHIFT]
+                [(opcode & BRANCH_CONDITION_MASK) != 0],
+            static_cast<Address>(
+                entry.pc + 2 + static_cast<std::int8_t>(zero))
+        );
+        return (text);
+    case InstructionType::TYPE1:
+        name = type1[operation];
+        switch (static_cast<AddrMode1>(mode))
+        {
+        case AddrMode1::INDEXED_INDIRECT_X:
+            std::snprintf(text, sizeof(text), "%s ($%02X,X)", name, zero);
+            break;
+        case AddrMode1::ZERO_PAGE:
+            std::snprintf(text, sizeof(text), "%s $%02X", name, zero);
+            break;
+        case AddrMode1::IMMEDIATE:
+            std::snprintf(text, sizeof(text), "%s #$%02X", name, zero);
+            break;
+        case AddrMode1::ABSOLUTE:
+            std::snprintf(text, sizeof(text), "%s $%04X", name, absolute);
+            break;
+        case AddrMode1::INDIRECT_Y:
+            std::snprintf(text, sizeof(text), "%s ($%02X),Y", name, zero);
+            break;
+        case AddrMode1::INDEXED_X:
+            std::snprintf(text, sizeof(text), "%s $%02X,X", name, zero);
+            break;
+        case AddrMode1::ABSOLUTE_Y:
+            std::snprintf(text, sizeof(text), "%s $%04X,Y", name, absolute);
+            break;
+        default:
+            std::snprintf(text, sizeof(text), "%s $%04X,X", name, absolute);
+            break;
+        }
+        return (text);
+    case InstructionType::TYPE0:
+    case InstructionType::TYPE2:
+    {
+        bool second = (opcode & INSTRUCTION_MODE_MASK) == 0x2;
+        // STX and LDX index with Y instead of X
+        char index = second && (operation ==
+            static_cast<int>(Operation2::STX) ||
+            operation == static_cast<int>(Operation2::LDX)) ? 'Y' : 'X';
+
+        name = second ? type2[operation] : type0[operation];
+        switch (static_cast<AddrMode2>(mode))
+        {
+        case AddrMode2::IMMEDIATE:
+            std::snprintf(text, sizeof(text), "%s #$%02X", name, zero);
+            break;
+        case AddrMode2::ZERO_PAGE:
+            std::snprintf(text, sizeof(text), "%s $%02X", name, zero);
+            break;
+        case AddrMode2::ACCUMULATOR:
+            std::snprintf(text, sizeof(text), "%s A", name);
+            break;
+        case AddrMode2::ABSOLUTE:
+            std::snprintf(text, sizeof(text), "%s $%04X", name, absolute);
+            break;
+        case AddrMode2::INDEXED:
+            std::snprintf(text, sizeof(text), "%s $%02X,%c",
+                name, zero, index);
+            break;
+        default:
+            std::snprintf(text, sizeof(text), "%s $%04X,%c",
+                name, absolute, index);
+            break;
+        }
+        return (text);
+    }
+    default:
+        return ("???");
+    }
+}
+
+} // !namespace NES
@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <functional>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Fixed-size ring of the last instructions the CPU executed
+///
+/// Entries are kept in binary form; turning them into nestest-style text
+/// only happens when the ring is dumped.
+///
+///////////////////////////////////////////////////////////////////////////////
+class Trace
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Machine state at the start of an instruction
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        Uint64 cycle;       //<! CPU cycle the instruction started on
+        Address pc;         //<! Address of the opcode
+        Byte opcode;        //<! Opcode of the instruction
+        Byte operands[2];   //<! Operand bytes, as many as it has
+        Byte a;             //<! Accumulator
+        Byte x;             //<! X index register
+        Byte y;             //<! Y index register
+        Byte p;             //<! Status register, bit 5 set, B clear
+        Byte sp;            //<! Stack pointer
+        Uint16 scanline;    //<! PPU scanline
+        Uint16 dot;         //<! PPU dot within the scanline
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Fill the PPU position of the CPU cycle an entry started on
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    using PositionCallback = std::function<void(Entry& entry)>;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<Entry> m_entries;       //<! Ring storage
+    std::size_t m_mask;                 //<! Capacity minus one
+    Uint64 m_count;                     //<! Entries recorded since Clear
+    PositionCallback m_position;        //<! Source of the PPU position
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Allocate the ring
+    ///
+    /// \param capacity Number of entries kept, a power of two
+    /// \param position Callback filling the PPU position of an entry
+    ///
+    /// \throw std::runtime_error if the capacity is not a power of two
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    Trace(std::size_t capacity, PositionCallback position);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Append an entry, overwriting the oldest one once full
+    ///
+    /// \param entry CPU state of the instruction, without the PPU position
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Record(const Entry& entry);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Forget every recorded entry
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Clear(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Get the number of entries currently held
+    ///
+    /// \return At most the capacity
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t GetSize(void) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write the held entries as nestest log lines, oldest first
+    ///
+    /// \param out Stream to write to
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Dump(std::ostream& out) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Format an entry the way nestest.log does
+    ///
+    /// Memory contents after the operand (" = 00") are left out, since they
+    /// are not known once the instruction has run.
+    ///
+    /// \param entry Entry to format
+    ///
+    /// \return One log line, without the line break
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static std::string Format(const Entry& entry);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Disassemble an instruction
+    ///
+    /// \param entry Entry holding the address, opcode and operand bytes
+    ///
+    /// \return The mnemonic and its operand in 6502 assembler syntax
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    static std::string Disassemble(const Entry& entry);
+};
+
+} // !namespace NES
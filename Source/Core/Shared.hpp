@@ -7,3 +7,4 @@
 // Dependencies
 ///////////////////////////////////////////////////////////////////////////////
 #include "Core/Shared/Bus.hpp"
+#include "Core/Shared/CodeDataLogger.hpp"
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Core/Shared/CodeDataLogger.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+CodeDataLogger::CodeDataLogger(std::size_t pgrSize, std::size_t chrSize)
+    : m_pgr(pgrSize, 0)
+    , m_chr(chrSize, 0)
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+void CodeDataLogger::Clear(void)
+{
+    std::fill(m_pgr.begin(), m_pgr.end(), 0);
+    std::fill(m_chr.begin(), m_chr.end(), 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t CodeDataLogger::CountPGR(Byte flags) const
+{
+    return (std::count_if(m_pgr.begin(), m_pgr.end(), [flags](Byte marks)
+    {
+        return ((marks & flags) != 0);
+    }));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t CodeDataLogger::CountCHR(Byte flags) const
+{
+    return (std::count_if(m_chr.begin(), m_chr.end(), [flags](Byte marks)
+    {
+        return ((marks & flags) != 0);
+    }));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CodeDataLogger::Save(const Path& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+
+    file.write(reinterpret_cast<const char*>(m_pgr.data()), m_pgr.size());
+    file.write(reinterpret_cast<const char*>(m_chr.data()), m_chr.size());
+
+    if (!file)
+    {
+        throw std::runtime_error(
+            "Failed to write CDL file: " + path.string()
+        );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CodeDataLogger::Load(const Path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<Byte> marks(m_pgr.size() + m_chr.size());
+
+    if (!file.read(reinterpret_cast<char*>(marks.data()), marks.size()) ||
+        file.peek() != std::ifstream::traits_type::eof())
+    {
+        throw std::runtime_error(
+            "CDL file does not match the ROM: " + path.string()
+        );
+    }
+
+    for (std::size_t i = 0; i < m_pgr.size(); i++)
+    {
+        m_pgr[i] |= marks[i];
+    }
+    for (std::size_t i = 0; i < m_chr.size(); i++)
+    {
+        m_chr[i] |= marks[m_pgr.size() + i];
+    }
+}
+
+} // !namespace NES
@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+// Header guard
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Dependencies
+///////////////////////////////////////////////////////////////////////////////
+#include "Utils.hpp"
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace NES
+///////////////////////////////////////////////////////////////////////////////
+namespace NES
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Code/Data Logger marking how every PGR and CHR ROM byte was used
+///
+/// Marks are kept per ROM offset, so a byte keeps the same entry whatever
+/// bank it is mapped through. Saved logs use the FCEUX layout: one byte per
+/// PGR ROM byte followed by one byte per CHR ROM byte.
+///
+///////////////////////////////////////////////////////////////////////////////
+class CodeDataLogger
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Marks of a PGR ROM byte
+    ///
+    /// CODE and DATA marks also record, in bits 2-3, which 8 KB window of
+    /// $8000-$FFFF the byte was seen through. Immediate operands are read
+    /// like any other operand, so they carry the DATA mark as well.
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum PGRFlag : Byte
+    {
+        CODE = 0x01,            //<! Executed as an opcode or operand
+        DATA = 0x02,            //<! Read as data
+        INDIRECT_CODE = 0x10,   //<! Jumped to through JMP ($nnnn)
+        INDIRECT_DATA = 0x20,   //<! Read through a ($nn,X) or ($nn),Y
+        PCM_DATA = 0x40         //<! Fetched by the DMC as a sample
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Marks of a CHR ROM byte
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    enum CHRFlag : Byte
+    {
+        RENDERED = 0x01,        //<! Fetched by the PPU to draw a tile
+        READ = 0x02             //<! Read by the CPU through PPUDATA
+    };
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Private members
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<Byte> m_pgr;    //<! Marks per PGR ROM offset
+    std::vector<Byte> m_chr;    //<! Marks per CHR ROM offset
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create an empty log
+    ///
+    /// \param pgrSize Size of PGR ROM in bytes
+    /// \param chrSize Size of CHR ROM in bytes, 0 for CHR RAM
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    CodeDataLogger(std::size_t pgrSize, std::size_t chrSize);
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Mark a PGR ROM byte
+    ///
+    /// \param offset Offset into PGR ROM, ignored if negative
+    /// \param address CPU address the byte was accessed through
+    /// \param flags PGRFlag values to add
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void LogPGR(Int32 offset, Address address, Byte flags)
+    {
+        if (offset >= 0)
+        {
+            m_pgr[offset] |= flags | ((address >> 13) & 0x3) << 2;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Mark a CHR ROM byte
+    ///
+    /// \param offset Offset into CHR ROM, ignored if negative
+    /// \param flags CHRFlag values to add
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void LogCHR(Int32 offset, Byte flags)
+    {
+        if (offset >= 0)
+        {
+            m_chr[offset] |= flags;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Forget every mark
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Clear(void);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Count the PGR ROM bytes carrying some marks
+    ///
+    /// \param flags PGRFlag values, any of which makes a byte count
+    ///
+    /// \return The number of bytes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t CountPGR(Byte flags) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Count the CHR ROM bytes carrying some marks
+    ///
+    /// \param flags CHRFlag values, any of which makes a byte count
+    ///
+    /// \return The number of bytes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t CountCHR(Byte flags) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Write the log to a .cdl file
+    ///
+    /// \param path Path of the file to write
+    ///
+    /// \throw std::runtime_error if the file cannot be written
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Save(const Path& path) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Merge a previously saved .cdl file into the log
+    ///
+    /// Lets coverage accumulate over several runs of the same ROM.
+    ///
+    /// \param path Path of the file to read
+    ///
+    /// \throw std::runtime_error if the file cannot be read or does not
+    /// match the ROM sizes
+    ///
+    ///////////////////////////////////////////////////////////////////////////
+    void Load(const Path& path);
+};
+
+} // !namespace NES
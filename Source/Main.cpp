@@ -8,7 +8,11 @@
 #include <SFML/System.hpp>
 #include <SFML/Audio.hpp>
 #include <iostream>
+#include <fstream>
 #include <chrono>
+#include <filesystem>
+#include <vector>
+#include <cstdio>
 
 void sfml(const std::string& romPath)
 {
@@ -47,6 +51,8 @@ void sfml(const std::string& romPath)
     finalSprite.setScale(3.0f, 3.0f);
 
     bool focus = true;
+    bool shown = false;
+    NES::Uint64 shownHash = 0;
 
     sf::Event event;
     while (window.isOpen())
@@ -96,13 +102,23 @@ void sfml(const std::string& romPath)
             // Update emulator state
             emulator.Update();
 
-            // Update PPU screen with the latest frame
-            texture.update(emulator.GetScreenData());
+            // Update PPU screen with the latest frame, unless it shows the
+            // same picture as the one already uploaded
+            const NES::FrameBuffer::Frame& frame = emulator.GetFrame();
 
-            // Render to texture first (your NES emulator output would go here)
-            renderTexture.clear(sf::Color::Black);
-            renderTexture.draw(sprite);
-            renderTexture.display();
+            if (!shown || frame.hash != shownHash)
+            {
+                texture.update(emulator.GetScreenData());
+
+                // Render to texture first (your NES emulator output would go
+                // here)
+                renderTexture.clear(sf::Color::Black);
+                renderTexture.draw(sprite);
+                renderTexture.display();
+
+                shown = true;
+                shownHash = frame.hash;
+            }
 
             // Set up shader uniforms
             crtShader.setUniform("texture", renderTexture.getTexture());
@@ -119,18 +135,194 @@ void sfml(const std::string& romPath)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void loadSymbols(NES::Profiler& profiler, const std::string& romPath)
+{
+    // FCEUX name lists sit next to the ROM, ca65 debug files replace its
+    // extension
+    std::vector<NES::Path> paths = {
+        NES::Path(romPath + ".ram.nl"),
+        NES::Path(romPath).replace_extension(".dbg")
+    };
+
+    for (int bank = 0; bank < 0x100; bank++)
+    {
+        char name[8];
+        std::snprintf(name, sizeof(name), ".%X.nl", bank);
+        paths.push_back(NES::Path(romPath + name));
+    }
+
+    for (const NES::Path& path : paths)
+    {
+        if (std::filesystem::exists(path))
+        {
+            std::cout << "Symbols: " << profiler.LoadSymbols(path)
+                << " from " << path.string() << std::endl;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void headless(
+    const std::string& romPath, int frames, bool dynarec, bool trace, bool cdl,
+    bool profile, bool ppuThread
+)
+{
+    NES::Emulator emulator(romPath);
+    NES::Path cdlPath = NES::Path(romPath).replace_extension(".cdl");
+
+    if (dynarec)
+    {
+        emulator.SetCPUBackend(NES::CPUBackend::DYNAREC);
+    }
+    if (trace)
+    {
+        emulator.EnableTrace(1 << 16);
+    }
+    if (ppuThread)
+    {
+        emulator.EnablePPUThread();
+    }
+    if (profile)
+    {
+        emulator.EnableProfiler(1000);
+        loadSymbols(*emulator.GetProfiler(), romPath);
+    }
+    if (cdl)
+    {
+        // Marks accumulate over the runs of a ROM
+        emulator.EnableCodeDataLogger();
+        if (std::filesystem::exists(cdlPath))
+        {
+            emulator.GetCodeDataLogger()->Load(cdlPath);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    NES::Uint64 lastFrame = 0;
+    int changed = 0;
+
+    try
+    {
+        for (int i = 0; i < frames; i++)
+        {
+            emulator.SkipOneCycle();
+
+            const NES::FrameBuffer::Frame& frame = emulator.GetFrame();
+
+            changed += frame.number != lastFrame && frame.changed;
+            lastFrame = frame.number;
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Keep what led to the failure before reporting it
+        if (trace)
+        {
+            std::ofstream log("trace.log");
+            emulator.DumpTrace(log);
+        }
+        throw;
+    }
+
+    // The last frame may still be drawn on the PPU thread
+    emulator.DisablePPUThread();
+
+    if (trace)
+    {
+        std::ofstream log("trace.log");
+        emulator.DumpTrace(log);
+    }
+    if (cdl)
+    {
+        emulator.GetCodeDataLogger()->Save(cdlPath);
+    }
+    if (profile)
+    {
+        std::ofstream folded("profile.folded");
+        emulator.GetProfiler()->WriteCollapsed(folded);
+    }
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+    NES::Uint64 instructions = emulator.GetCPU().GetInstructionCount();
+    NES::Uint64 idle = emulator.GetCPU().GetIdleCycles();
+    NES::Uint64 fused = emulator.GetCPU().GetFusedInstructionCount();
+
+    // FNV-1a of the last frame, to compare runs of the two backends
+    const NES::Byte* screen = emulator.GetScreenData();
+    NES::Uint64 hash = 0xCBF29CE484222325;
+    for (int i = 0; i < NES::NES_WIDTH * NES::NES_HEIGHT * 4; i++)
+    {
+        hash = (hash ^ screen[i]) * 0x100000001B3;
+    }
+
+    std::cout << "Frames: " << frames << std::endl;
+    std::cout << "Time: " << seconds << " s" << std::endl;
+    std::cout << "FPS: " << frames / seconds << std::endl;
+    std::cout << "Instructions: " << instructions << std::endl;
+    std::cout << "IPS: " << instructions / seconds << std::endl;
+    std::cout << "Idle cycles elided: " << idle << " ("
+        << 100.0 * idle / emulator.GetCPU().GetCycles() << "%)" << std::endl;
+    std::cout << "Fused instructions: " << fused << " ("
+        << 100.0 * fused / instructions << "%)" << std::endl;
+    std::cout << "Screen hash: " << std::hex << hash << std::dec << std::endl;
+    std::cout << "Changed frames: " << changed << std::endl;
+
+    if (cdl)
+    {
+        const NES::CodeDataLogger& log = *emulator.GetCodeDataLogger();
+
+        std::cout << "PGR code bytes: "
+            << log.CountPGR(NES::CodeDataLogger::CODE) << std::endl;
+        std::cout << "PGR data bytes: "
+            << log.CountPGR(NES::CodeDataLogger::DATA) << std::endl;
+        std::cout << "CHR rendered bytes: "
+            << log.CountCHR(NES::CodeDataLogger::RENDERED) << std::endl;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int main(int argc, char *argv[])
 {
     if (argc < 2)
     {
-        std::cerr << "Usage: " << argv[0] << " <path_to_rom>" << std::endl;
+        std::cerr << "Usage: " << argv[0]
+            << " <path_to_rom>"
+            << " [--headless <frames> [--dynarec] [--trace] [--cdl]"
+            << " [--profile] [--ppu-thread]]"
+            << std::endl;
         return (1);
     }
 
     try
     {
-        sfml(argv[1]);
+        if (argc >= 4 && std::string(argv[2]) == "--headless")
+        {
+            bool dynarec = false;
+            bool trace = false;
+            bool cdl = false;
+            bool profile = false;
+            bool ppuThread = false;
+
+            for (int i = 4; i < argc; i++)
+            {
+                dynarec |= std::string(argv[i]) == "--dynarec";
+                trace |= std::string(argv[i]) == "--trace";
+                cdl |= std::string(argv[i]) == "--cdl";
+                profile |= std::string(argv[i]) == "--profile";
+                ppuThread |= std::string(argv[i]) == "--ppu-thread";
+            }
+            headless(
+                argv[1], std::stoi(argv[3]), dynarec, trace, cdl, profile,
+                ppuThread
+            );
+        }
+        else
+        {
+            sfml(argv[1]);
+        }
     }
     catch (const std::exception &e)
     {